@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace JNI {
+
+// View of the memory behind a direct java.nio.ByteBuffer. Converting between the two
+// never copies, so the memory must stay valid for as long as either side uses it.
+class DirectBuffer final {
+public:
+    DirectBuffer()
+        : m_data(nullptr)
+        , m_size(0)
+    {
+    }
+    DirectBuffer(void* data, size_t size)
+        : m_data(static_cast<uint8_t*>(data))
+        , m_size(data ? size : 0)
+    {
+    }
+
+    uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return !m_size; }
+
+    uint8_t* begin() const { return m_data; }
+    uint8_t* end() const { return m_data + m_size; }
+    uint8_t& operator[](size_t index) const { return m_data[index]; }
+
+    DirectBuffer slice(size_t offset, size_t count = SIZE_MAX) const
+    {
+        offset = std::min(offset, m_size);
+        return DirectBuffer(m_data + offset, std::min(count, m_size - offset));
+    }
+
+private:
+    uint8_t* m_data;
+    size_t m_size;
+}; // class DirectBuffer
+
+} // namespace JNI
@@ -61,18 +61,38 @@ public:
     {
         refIfNotNull();
     }
+    GlobalRef(GlobalRef&& ref) noexcept
+        : m_ptr(ref.m_ptr)
+        , m_ref(ref.m_ref)
+    {
+        ref.m_ptr = nullptr;
+        ref.m_ref = 0;
+    }
     template<typename U> GlobalRef(const GlobalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(JNI::refGlobal(ref.get()))
     {
         refIfNotNull();
     }
+    template<typename U> GlobalRef(GlobalRef<U>&& ref) noexcept
+        : m_ptr(ref.template getPtr<T>())
+        , m_ref(ref.m_ref)
+    {
+        ref.m_ptr = nullptr;
+        ref.m_ref = 0;
+    }
     template<typename U> GlobalRef(const LocalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(JNI::refGlobal(ref.get()))
     {
         refIfNotNull();
     }
+    template<typename U> GlobalRef(const SharedGlobalRef<U>& ref)
+        : m_ptr(ref.template getPtr<T>())
+        , m_ref(JNI::refGlobal(ref.get()))
+    {
+        refIfNotNull();
+    }
     template<typename U> GlobalRef(const PassLocalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(JNI::refGlobal(ref.get()))
@@ -116,15 +136,19 @@ public:
     operator UnspecifiedBoolType() const { return m_ref ? &GlobalRef::m_ref : nullptr; }
 
     GlobalRef& operator=(const GlobalRef&);
+    GlobalRef& operator=(GlobalRef&&);
     GlobalRef& operator=(T*);
     GlobalRef& operator=(const PassLocalRef<T>&);
     template<typename U> GlobalRef& operator=(const GlobalRef<U>&);
+    template<typename U> GlobalRef& operator=(GlobalRef<U>&&);
     template<typename U> GlobalRef& operator=(const LocalRef<U>&);
     template<typename U> GlobalRef& operator=(const PassLocalRef<U>&);
 
     void swap(GlobalRef&);
 
 private:
+    template<typename U> friend class GlobalRef;
+
     void refIfNotNull()
     {
         if (m_ptr) {
@@ -159,12 +183,26 @@ template<typename T> inline GlobalRef<T>& GlobalRef<T>::operator=(const GlobalRe
     return *this;
 }
     
+template<typename T> inline GlobalRef<T>& GlobalRef<T>::operator=(GlobalRef&& o)
+{
+    GlobalRef ptr = std::move(o);
+    swap(ptr);
+    return *this;
+}
+
 template<typename T> template<typename U> inline GlobalRef<T>& GlobalRef<T>::operator=(const GlobalRef<U>& o)
 {
     GlobalRef ptr = o;
     swap(ptr);
     return *this;
 }
+
+template<typename T> template<typename U> inline GlobalRef<T>& GlobalRef<T>::operator=(GlobalRef<U>&& o)
+{
+    GlobalRef ptr = std::move(o);
+    swap(ptr);
+    return *this;
+}
     
 template<typename T> template<typename U> inline GlobalRef<T>& GlobalRef<T>::operator=(const LocalRef<U>& o)
 {
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace JNI {
+
+// A string converted to Java through the string intern cache, so passing the same
+// content again reuses the cached Java string instead of creating a new one.
+// Meant for keys, tags and other values drawn from a small set.
+//
+// A const char*, typically a literal, is only pointed to and must outlive the
+// InternedString; a std::string is moved in and owned. Either way the cache is
+// searched with the characters in place, so a cached constant crosses without
+// allocating.
+class InternedString final {
+public:
+    InternedString(const char* value) : m_data(value), m_length(strlen(value)) { }
+    InternedString(std::string value) : m_data(nullptr), m_length(value.size()), m_owned(std::move(value)) { }
+
+    const char* data() const { return m_data ? m_data : m_owned.data(); }
+    size_t size() const { return m_length; }
+
+    std::string string() const { return std::string(data(), m_length); }
+    operator std::string() const { return string(); }
+
+private:
+    const char* m_data;
+    size_t m_length;
+    std::string m_owned;
+}; // class InternedString
+
+} // namespace JNI
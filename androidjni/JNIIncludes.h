@@ -25,5 +25,10 @@
 
 #pragma once
 
+#include "DirectBuffer.h"
+#include "InternedString.h"
 #include "LocalRef.h"
+#include "StringInternCache.h"
+#include <androidjni/CriticalArrayView.h>
 #include <androidjni/PassArray.h>
+#include <androidjni/StringView.h>
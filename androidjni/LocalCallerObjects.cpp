@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ReferenceFunctions.h"
+
+#include <cstdlib>
+
+namespace JNI {
+
+#if defined(_MSC_VER)
+#define thread_local __declspec(thread)
+#endif
+
+// Stack of Java objects whose native peers are being constructed on this thread.
+// Constructions rarely nest deeply, so the first entries live inline and deeper
+// ones spill to a heap buffer. The buffer is kept until the thread exits, so a
+// depth hovering around the inline capacity does not allocate on every push.
+// The struct stays POD so that it can be a __declspec(thread) variable.
+struct LocalCallerObjectStack {
+    static const size_t inlineCapacity = 16;
+
+    ref_t inlineRefs[inlineCapacity];
+    ref_t* spillRefs;
+    size_t spillCapacity;
+    size_t size;
+};
+
+static thread_local LocalCallerObjectStack localCallerObjects;
+
+#if defined(_MSC_VER)
+// __declspec(thread) variables have no destructors, so the buffer is released once the stack drains.
+static void keepSpillRefsUntilThreadExit() { }
+
+static void stackDrained(LocalCallerObjectStack& stack)
+{
+    free(stack.spillRefs);
+    stack.spillRefs = nullptr;
+    stack.spillCapacity = 0;
+}
+#else
+struct SpillRefsReleaser {
+    ~SpillRefsReleaser() { free(localCallerObjects.spillRefs); }
+    void use() { }
+};
+
+static thread_local SpillRefsReleaser spillRefsReleaser;
+
+static void keepSpillRefsUntilThreadExit()
+{
+    spillRefsReleaser.use();
+}
+
+static void stackDrained(LocalCallerObjectStack&) { }
+#endif
+
+ref_t popLocalCallerObjectRef()
+{
+    LocalCallerObjectStack& stack = localCallerObjects;
+    if (!stack.size)
+        return 0;
+
+    size_t index = --stack.size;
+    if (index >= LocalCallerObjectStack::inlineCapacity)
+        return stack.spillRefs[index - LocalCallerObjectStack::inlineCapacity];
+
+    if (!index && stack.spillRefs)
+        stackDrained(stack);
+    return stack.inlineRefs[index];
+}
+
+void pushLocalCallerObjectRef(ref_t ref)
+{
+    LocalCallerObjectStack& stack = localCallerObjects;
+    size_t index = stack.size;
+    if (index < LocalCallerObjectStack::inlineCapacity) {
+        stack.inlineRefs[index] = ref;
+        ++stack.size;
+        return;
+    }
+
+    size_t spillIndex = index - LocalCallerObjectStack::inlineCapacity;
+    if (spillIndex == stack.spillCapacity) {
+        if (!stack.spillRefs)
+            keepSpillRefsUntilThreadExit();
+        size_t capacity = stack.spillCapacity ? stack.spillCapacity * 2 : LocalCallerObjectStack::inlineCapacity;
+        ref_t* refs = static_cast<ref_t*>(realloc(stack.spillRefs, capacity * sizeof(ref_t)));
+        assert(refs);
+        stack.spillRefs = refs;
+        stack.spillCapacity = capacity;
+    }
+    stack.spillRefs[spillIndex] = ref;
+    ++stack.size;
+}
+
+} // namespace JNI
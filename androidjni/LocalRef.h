@@ -61,18 +61,38 @@ public:
     {
         refIfNotNull();
     }
+    LocalRef(LocalRef&& ref) noexcept
+        : m_ptr(ref.m_ptr)
+        , m_ref(ref.m_ref)
+    {
+        ref.m_ptr = nullptr;
+        ref.m_ref = 0;
+    }
     template<typename U> LocalRef(const LocalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(JNI::refLocal(ref.get()))
     {
         refIfNotNull();
     }
+    template<typename U> LocalRef(LocalRef<U>&& ref) noexcept
+        : m_ptr(ref.template getPtr<T>())
+        , m_ref(ref.m_ref)
+    {
+        ref.m_ptr = nullptr;
+        ref.m_ref = 0;
+    }
     template<typename U> LocalRef(const GlobalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(JNI::refLocal(ref.get()))
     {
         refIfNotNull();
     }
+    template<typename U> LocalRef(const SharedGlobalRef<U>& ref)
+        : m_ptr(ref.template getPtr<T>())
+        , m_ref(JNI::refLocal(ref.get()))
+    {
+        refIfNotNull();
+    }
     template<typename U> LocalRef(const PassLocalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(ref.leak())
@@ -114,15 +134,20 @@ public:
     operator UnspecifiedBoolType() const { return m_ref ? &LocalRef::m_ref : nullptr; }
 
     LocalRef& operator=(const LocalRef&);
+    LocalRef& operator=(LocalRef&&);
     LocalRef& operator=(T*);
     LocalRef& operator=(const PassLocalRef<T>&);
     template<typename U> LocalRef& operator=(const LocalRef<U>&);
+    template<typename U> LocalRef& operator=(LocalRef<U>&&);
     template<typename U> LocalRef& operator=(const GlobalRef<U>&);
     template<typename U> LocalRef& operator=(const PassLocalRef<U>&);
 
     void swap(LocalRef&);
 
 private:
+    template<typename U> friend class LocalRef;
+    template<typename U> friend class PassLocalRef;
+
     void refIfNotNull()
     {
         if (m_ptr) {
@@ -157,12 +182,26 @@ template<typename T> inline LocalRef<T>& LocalRef<T>::operator=(const LocalRef&
     return *this;
 }
     
+template<typename T> inline LocalRef<T>& LocalRef<T>::operator=(LocalRef&& o)
+{
+    LocalRef ptr = std::move(o);
+    swap(ptr);
+    return *this;
+}
+
 template<typename T> template<typename U> inline LocalRef<T>& LocalRef<T>::operator=(const LocalRef<U>& o)
 {
     LocalRef ptr = o;
     swap(ptr);
     return *this;
 }
+
+template<typename T> template<typename U> inline LocalRef<T>& LocalRef<T>::operator=(LocalRef<U>&& o)
+{
+    LocalRef ptr = std::move(o);
+    swap(ptr);
+    return *this;
+}
     
 template<typename T> template<typename U> inline LocalRef<T>& LocalRef<T>::operator=(const GlobalRef<U>& o)
 {
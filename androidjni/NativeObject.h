@@ -26,20 +26,22 @@
 #pragma once
 
 #include "AnyObject.h"
+#include "NativeObjectHandles.h"
 
 namespace JNI {
 
+// Common base of the native peers of Java objects. How references are counted
+// is up to RefCountedNativeObject and its RefCount policy.
 class JNI_EXPORT NativeObject : public AnyObject {
 public:
     NativeObject()
-        : m_refCount(1)
-        , m_bind(JNI::refWeakGlobal(JNI::popLocalCallerObjectRef()))
+        : m_bind(JNI::refWeakGlobal(JNI::popLocalCallerObjectRef()))
     {
     }
     virtual ~NativeObject() { JNI::derefWeakGlobal(m_bind); }
 
-    void ref() override { ++m_refCount; }
-    void deref() override { --m_refCount; deleteIfPossible(); }
+    void ref() override = 0;
+    void deref() override = 0;
 
     ref_t refLocal() override { return JNI::refLocal(m_bind); }
     ref_t refGlobal() override { return JNI::refGlobal(m_bind); }
@@ -48,12 +50,47 @@ protected:
     NativeObject(const NativeObject&) = delete;
     NativeObject& operator=(const NativeObject&) = delete;
 
-    void deleteIfPossible() { if (m_refCount > 0) return; delete this; }
-
-    std::atomic<int32_t> m_refCount;
     weak_t m_bind;
 }; // class NativeObject
 
+// For objects referenced from any thread. Increments are relaxed; the decrement
+// releasing the last reference synchronizes with all earlier ones.
+class AtomicRefCount final {
+public:
+    AtomicRefCount() : m_count(1) { }
+
+    void ref() { m_count.fetch_add(1, std::memory_order_relaxed); }
+    bool deref() { return m_count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+private:
+    std::atomic<int32_t> m_count;
+};
+
+// For objects that are only ever referenced from a single thread.
+class ThreadConfinedRefCount final {
+public:
+    ThreadConfinedRefCount() : m_count(1) { }
+
+    void ref() { ++m_count; }
+    bool deref() { return !--m_count; }
+
+private:
+    int32_t m_count;
+};
+
+template<typename RefCount = AtomicRefCount>
+class RefCountedNativeObject : public NativeObject {
+public:
+    void ref() override { m_refCount.ref(); }
+    void deref() override { if (m_refCount.deref()) delete this; }
+
+protected:
+    RefCountedNativeObject() = default;
+
+private:
+    RefCount m_refCount;
+}; // class RefCountedNativeObject
+
 template<typename T> inline T* getPtr(ref_t, NativeObject* ptr)
 {
     return static_cast<T*>(ptr);
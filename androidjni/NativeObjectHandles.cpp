@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NativeObjectHandles.h"
+
+#include "NativeObject.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace JNI {
+
+static const uint32_t segmentShift = 12;
+static const uint32_t segmentSize = 1u << segmentShift;
+static const uint32_t maximumSegments = 4096;
+static const uint32_t noFreeSlot = UINT32_MAX;
+
+struct HandleSlot {
+    std::atomic<uint32_t> generation;
+    std::atomic<NativeObject*> object;
+    // Number of refNativeObjectHandle calls currently between their generation check and ref().
+    std::atomic<uint32_t> readers;
+    uint32_t nextFree;
+};
+
+struct HandleTable {
+    // Segments are never freed or moved, so lookups can index them without locking.
+    std::atomic<HandleSlot*> segments[maximumSegments];
+
+    std::mutex mutex;
+    uint32_t slotCount;
+    uint32_t firstFree;
+};
+
+static HandleTable& handleTable()
+{
+    static HandleTable* table = []() {
+        HandleTable* table = new HandleTable();
+        table->firstFree = noFreeSlot;
+        return table;
+    }();
+    return *table;
+}
+
+static inline int64_t makeHandle(uint32_t generation, uint32_t index)
+{
+    return static_cast<int64_t>((static_cast<uint64_t>(generation) << 32) | index);
+}
+
+static inline HandleSlot* slotForHandle(HandleTable& table, int64_t handle, uint32_t& generation)
+{
+    uint64_t bits = static_cast<uint64_t>(handle);
+    uint32_t index = static_cast<uint32_t>(bits);
+    generation = static_cast<uint32_t>(bits >> 32);
+    if (!generation || (index >> segmentShift) >= maximumSegments)
+        return nullptr;
+
+    HandleSlot* segment = table.segments[index >> segmentShift].load(std::memory_order_acquire);
+    if (!segment)
+        return nullptr;
+
+    return &segment[index & (segmentSize - 1)];
+}
+
+int64_t addNativeObjectHandle(NativeObject* object)
+{
+    if (!object)
+        return 0;
+
+    HandleTable& table = handleTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    uint32_t index = table.firstFree;
+    HandleSlot* slot;
+    if (index != noFreeSlot) {
+        slot = &table.segments[index >> segmentShift].load(std::memory_order_relaxed)[index & (segmentSize - 1)];
+        table.firstFree = slot->nextFree;
+    } else {
+        index = table.slotCount;
+        if ((index >> segmentShift) >= maximumSegments)
+            return 0;
+
+        HandleSlot* segment = table.segments[index >> segmentShift].load(std::memory_order_relaxed);
+        if (!segment) {
+            segment = new HandleSlot[segmentSize]();
+            for (uint32_t i = 0; i < segmentSize; ++i)
+                segment[i].generation.store(1, std::memory_order_relaxed);
+            table.segments[index >> segmentShift].store(segment, std::memory_order_release);
+        }
+        slot = &segment[index & (segmentSize - 1)];
+        ++table.slotCount;
+    }
+
+    slot->object.store(object, std::memory_order_release);
+    return makeHandle(slot->generation.load(std::memory_order_relaxed), index);
+}
+
+NativeObject* lookupNativeObjectHandle(int64_t handle)
+{
+    uint32_t generation;
+    HandleSlot* slot = slotForHandle(handleTable(), handle, generation);
+    if (!slot)
+        return nullptr;
+
+    NativeObject* object = slot->object.load(std::memory_order_acquire);
+    if (slot->generation.load(std::memory_order_acquire) != generation)
+        return nullptr;
+
+    return object;
+}
+
+NativeObject* refNativeObjectHandle(int64_t handle)
+{
+    uint32_t generation;
+    HandleSlot* slot = slotForHandle(handleTable(), handle, generation);
+    if (!slot)
+        return nullptr;
+
+    // Pairs with removeNativeObjectHandle: either the remover sees this reader and waits for it,
+    // or this reader sees the new generation and backs off.
+    slot->readers.fetch_add(1, std::memory_order_seq_cst);
+    NativeObject* object = nullptr;
+    if (slot->generation.load(std::memory_order_seq_cst) == generation) {
+        object = slot->object.load(std::memory_order_acquire);
+        if (object)
+            object->ref();
+    }
+    slot->readers.fetch_sub(1, std::memory_order_release);
+    return object;
+}
+
+NativeObject* refNativeObjectField(int32_t value)
+{
+    NativeObject* object = nativeObjectFromField(value);
+    if (object)
+        object->ref();
+    return object;
+}
+
+NativeObject* removeNativeObjectHandle(int64_t handle)
+{
+    HandleTable& table = handleTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    uint32_t generation;
+    HandleSlot* slot = slotForHandle(table, handle, generation);
+    if (!slot || slot->generation.load(std::memory_order_relaxed) != generation)
+        return nullptr;
+
+    NativeObject* object = slot->object.load(std::memory_order_relaxed);
+    if (!object)
+        return nullptr;
+
+    // Invalidate the handle before clearing the slot, so a concurrent lookup sees either the old object or a stale generation.
+    // Readers that passed the generation check before it changed are let finish taking their reference, which keeps the
+    // object alive past the caller's deref().
+    uint32_t nextGeneration = generation + 1;
+    slot->generation.store(nextGeneration ? nextGeneration : 1, std::memory_order_seq_cst);
+    while (slot->readers.load(std::memory_order_seq_cst))
+        std::this_thread::yield();
+    slot->object.store(nullptr, std::memory_order_release);
+
+    uint32_t index = static_cast<uint32_t>(static_cast<uint64_t>(handle));
+    slot->nextFree = table.firstFree;
+    table.firstFree = index;
+    return object;
+}
+
+} // namespace JNI
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JNIExportMacros.h"
+
+#include <cstdint>
+
+namespace JNI {
+
+class NativeObject;
+
+// Table of native objects owned by Java objects through a @NativeObjectField.
+// A handle packs a slot index (low 32 bits) and the slot's generation (high 32
+// bits), so handles of destroyed objects are rejected instead of dereferenced.
+// Lookups are lock-free; adding and removing take a lock. Adding returns 0 once
+// the table is full, which generated constructors report as an OutOfMemoryError.
+JNI_EXPORT int64_t addNativeObjectHandle(NativeObject*);
+JNI_EXPORT NativeObject* lookupNativeObjectHandle(int64_t);
+// Like lookupNativeObjectHandle, but also takes a reference on the object.
+// The reference is taken under the generation check, so a concurrent removal
+// either makes this return null or waits until the reference is taken; a plain
+// lookup followed by ref() could touch an object that was already destroyed.
+JNI_EXPORT NativeObject* refNativeObjectHandle(int64_t);
+JNI_EXPORT NativeObject* removeNativeObjectHandle(int64_t);
+
+// Conversions between native objects and the value stored in the field. long
+// fields hold handles; int fields hold the pointer itself, which only works on
+// 32-bit ABIs and is kept for existing classes.
+template<typename FieldType> FieldType adoptNativeObjectField(NativeObject*);
+
+template<> inline int64_t adoptNativeObjectField<int64_t>(NativeObject* object)
+{
+    return addNativeObjectHandle(object);
+}
+
+template<> inline int32_t adoptNativeObjectField<int32_t>(NativeObject* object)
+{
+    return static_cast<int32_t>(reinterpret_cast<intptr_t>(object));
+}
+
+inline NativeObject* nativeObjectFromField(int64_t handle)
+{
+    return lookupNativeObjectHandle(handle);
+}
+
+inline NativeObject* nativeObjectFromField(int32_t value)
+{
+    return reinterpret_cast<NativeObject*>(static_cast<intptr_t>(value));
+}
+
+inline NativeObject* refNativeObjectField(int64_t handle)
+{
+    return refNativeObjectHandle(handle);
+}
+
+JNI_EXPORT NativeObject* refNativeObjectField(int32_t);
+
+inline NativeObject* releaseNativeObjectField(int64_t handle)
+{
+    return removeNativeObjectHandle(handle);
+}
+
+inline NativeObject* releaseNativeObjectField(int32_t value)
+{
+    return nativeObjectFromField(value);
+}
+
+} // namespace JNI
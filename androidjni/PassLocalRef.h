@@ -45,6 +45,9 @@ class GlobalRef;
 template<typename T>
 class WeakGlobalRef;
 
+template<typename T>
+class SharedGlobalRef;
+
 template<typename T>
 class PassLocalRef final {
 public:
@@ -73,6 +76,11 @@ public:
         , m_ref(ref.leak())
     {
     }
+    PassLocalRef(PassLocalRef&& ref) noexcept
+        : m_ptr(ref.m_ptr)
+        , m_ref(ref.leak())
+    {
+    }
     template<typename U> PassLocalRef(const PassLocalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(ref.leak())
@@ -84,12 +92,25 @@ public:
     {
         refIfNotNull();
     }
+    template<typename U> PassLocalRef(LocalRef<U>&& ref) noexcept
+        : m_ptr(ref.template getPtr<T>())
+        , m_ref(ref.m_ref)
+    {
+        ref.m_ptr = nullptr;
+        ref.m_ref = 0;
+    }
     template<typename U> PassLocalRef(const GlobalRef<U>& ref)
         : m_ptr(ref.template getPtr<T>())
         , m_ref(JNI::refLocal(ref.get()))
     {
         refIfNotNull();
     }
+    template<typename U> PassLocalRef(const SharedGlobalRef<U>& ref)
+        : m_ptr(ref.template getPtr<T>())
+        , m_ref(JNI::refLocal(ref.get()))
+    {
+        refIfNotNull();
+    }
     ~PassLocalRef()
     {
         derefIfNotNull();
@@ -119,6 +140,14 @@ public:
 
     bool operator!() const { return !m_ref; }
 
+    PassLocalRef& operator=(PassLocalRef&& o)
+    {
+        PassLocalRef ptr = std::move(o);
+        std::swap(m_ptr, ptr.m_ptr);
+        std::swap(m_ref, ptr.m_ref);
+        return *this;
+    }
+
     template<typename U> PassLocalRef<U> as()
     {
         T* optr = nullptr;
@@ -173,6 +202,7 @@ private:
     template<typename U> friend class LocalRef;
     template<typename U> friend class GlobalRef;
     template<typename U> friend class WeakGlobalRef;
+    template<typename U> friend class SharedGlobalRef;
 
     mutable T* m_ptr;
     mutable ref_t m_ref;
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ReferenceCensus.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+#if !defined(WIN32)
+#include <dlfcn.h>
+#endif
+
+namespace JNI {
+
+static const size_t referenceKindCount = 3;
+
+struct CensusCounter {
+    std::atomic<int64_t> live;
+    std::atomic<int64_t> highWater;
+    std::atomic<uint64_t> created;
+    std::atomic<uint64_t> deleted;
+};
+
+struct CallSiteCounts {
+    int64_t live[referenceKindCount];
+    uint64_t created[referenceKindCount];
+};
+
+struct CensusState {
+    CensusCounter counters[referenceKindCount];
+
+    std::mutex mutex;
+    // References are not unique on every platform, so a reference may map to several call sites.
+    std::unordered_multimap<const void*, const void*> liveReferences[referenceKindCount];
+    std::unordered_map<const void*, CallSiteCounts> callSites;
+};
+
+static CensusState& censusState()
+{
+    static CensusState* state = new CensusState();
+    return *state;
+}
+
+void addCensusReference(ReferenceKind kind, const void* ref, const void* caller)
+{
+    if (!ref)
+        return;
+
+    size_t index = static_cast<size_t>(kind);
+    CensusState& state = censusState();
+    CensusCounter& counter = state.counters[index];
+
+    counter.created.fetch_add(1, std::memory_order_relaxed);
+    if (kind == ReferenceKind::Local) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        ++state.callSites[caller].created[index];
+        return;
+    }
+
+    int64_t live = counter.live.fetch_add(1, std::memory_order_relaxed) + 1;
+    int64_t highWater = counter.highWater.load(std::memory_order_relaxed);
+    while (live > highWater && !counter.highWater.compare_exchange_weak(highWater, live, std::memory_order_relaxed)) { }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.liveReferences[index].emplace(ref, caller);
+    CallSiteCounts& site = state.callSites[caller];
+    ++site.live[index];
+    ++site.created[index];
+}
+
+void removeCensusReference(ReferenceKind kind, const void* ref)
+{
+    if (!ref)
+        return;
+
+    size_t index = static_cast<size_t>(kind);
+    CensusState& state = censusState();
+    if (kind == ReferenceKind::Local) {
+        state.counters[index].deleted.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto found = state.liveReferences[index].find(ref);
+    if (found == state.liveReferences[index].end())
+        return; // Not created through ReferenceFunctions.
+
+    state.counters[index].live.fetch_sub(1, std::memory_order_relaxed);
+    state.counters[index].deleted.fetch_add(1, std::memory_order_relaxed);
+    --state.callSites[found->second].live[index];
+    state.liveReferences[index].erase(found);
+}
+
+bool isReferenceCensusEnabled()
+{
+#if defined(ENABLE_REFERENCE_CENSUS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+static ReferenceCount loadCount(const CensusCounter& counter)
+{
+    ReferenceCount count;
+    count.live = counter.live.load(std::memory_order_relaxed);
+    count.highWater = counter.highWater.load(std::memory_order_relaxed);
+    count.created = counter.created.load(std::memory_order_relaxed);
+    count.deleted = counter.deleted.load(std::memory_order_relaxed);
+    return count;
+}
+
+ReferenceCensus referenceCensus()
+{
+    CensusState& state = censusState();
+    ReferenceCensus census;
+    census.local = loadCount(state.counters[static_cast<size_t>(ReferenceKind::Local)]);
+    census.global = loadCount(state.counters[static_cast<size_t>(ReferenceKind::Global)]);
+    census.weakGlobal = loadCount(state.counters[static_cast<size_t>(ReferenceKind::WeakGlobal)]);
+
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (auto& entry : state.callSites) {
+            for (size_t index = 0; index < referenceKindCount; ++index) {
+                if (!entry.second.created[index])
+                    continue;
+
+                ReferenceCallSite site;
+                site.caller = entry.first;
+                site.kind = static_cast<ReferenceKind>(index);
+                site.live = entry.second.live[index];
+                site.created = entry.second.created[index];
+                census.callSites.push_back(site);
+            }
+        }
+    }
+
+    std::sort(census.callSites.begin(), census.callSites.end(), [](const ReferenceCallSite& a, const ReferenceCallSite& b) {
+        return a.live > b.live || (a.live == b.live && a.created > b.created);
+    });
+    return census;
+}
+
+static const char* referenceKindName(ReferenceKind kind)
+{
+    switch (kind) {
+    case ReferenceKind::Local:
+        return "local";
+    case ReferenceKind::Global:
+        return "global";
+    case ReferenceKind::WeakGlobal:
+        return "weak";
+    }
+    return "";
+}
+
+static std::string describeCaller(const void* caller)
+{
+    char buffer[512];
+#if !defined(WIN32)
+    Dl_info info;
+    if (dladdr(caller, &info) && info.dli_sname) {
+        snprintf(buffer, sizeof(buffer), "%s+0x%zx", info.dli_sname, static_cast<size_t>(static_cast<const char*>(caller) - static_cast<const char*>(info.dli_saddr)));
+        return buffer;
+    }
+    if (dladdr(caller, &info) && info.dli_fname) {
+        snprintf(buffer, sizeof(buffer), "%s+0x%zx", info.dli_fname, static_cast<size_t>(static_cast<const char*>(caller) - static_cast<const char*>(info.dli_fbase)));
+        return buffer;
+    }
+#endif
+    snprintf(buffer, sizeof(buffer), "%p", caller);
+    return buffer;
+}
+
+std::string referenceCensusReport(size_t maxCallSites)
+{
+    if (!isReferenceCensusEnabled())
+        return "JNI reference census is disabled; build with ENABLE_REFERENCE_CENSUS.";
+
+    ReferenceCensus census = referenceCensus();
+
+    std::string report = "JNI reference census (live / high water / created / deleted):\n";
+    char line[640];
+    snprintf(line, sizeof(line), "  %-6s - / - / %" PRIu64 " / %" PRIu64 "\n", referenceKindName(ReferenceKind::Local), census.local.created, census.local.deleted);
+    report += line;
+    const ReferenceCount* counts[] = { &census.global, &census.weakGlobal };
+    for (size_t index = 0; index < 2; ++index) {
+        snprintf(line, sizeof(line), "  %-6s %" PRId64 " / %" PRId64 " / %" PRIu64 " / %" PRIu64 "\n", referenceKindName(static_cast<ReferenceKind>(index + 1)),
+            counts[index]->live, counts[index]->highWater, counts[index]->created, counts[index]->deleted);
+        report += line;
+    }
+
+    size_t count = std::min(maxCallSites, census.callSites.size());
+    for (size_t index = 0; index < count; ++index) {
+        const ReferenceCallSite& site = census.callSites[index];
+        if (!site.live)
+            break;
+
+        snprintf(line, sizeof(line), "  %" PRId64 " live %s (%" PRIu64 " created) from %s\n", site.live, referenceKindName(site.kind),
+            site.created, describeCaller(site.caller).c_str());
+        report += line;
+    }
+
+    return report;
+}
+
+} // namespace JNI
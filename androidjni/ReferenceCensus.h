@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ReferenceFunctions.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace JNI {
+
+// Accounting of the references created through ReferenceFunctions. It is only
+// collected when the library is built with ENABLE_REFERENCE_CENSUS.
+
+enum class ReferenceKind {
+    Local,
+    Global,
+    WeakGlobal,
+};
+
+// Local references are also freed by PopLocalFrame and by returning to Java,
+// which the census never sees, so locals are only counted as created/deleted
+// totals; live and highWater are tracked for global and weak references only.
+struct ReferenceCount {
+    int64_t live;
+    int64_t highWater;
+    uint64_t created;
+    uint64_t deleted;
+};
+
+struct ReferenceCallSite {
+    const void* caller;
+    ReferenceKind kind;
+    int64_t live; // Always 0 for local references.
+    uint64_t created;
+};
+
+struct ReferenceCensus {
+    ReferenceCount local;
+    ReferenceCount global;
+    ReferenceCount weakGlobal;
+    std::vector<ReferenceCallSite> callSites; // Sorted by live count, highest first.
+};
+
+JNI_EXPORT bool isReferenceCensusEnabled();
+JNI_EXPORT ReferenceCensus referenceCensus();
+// Human readable summary listing the maxCallSites call sites holding the most live references.
+JNI_EXPORT std::string referenceCensusReport(size_t maxCallSites = 20);
+
+JNI_EXPORT void addCensusReference(ReferenceKind, const void* ref, const void* caller);
+JNI_EXPORT void removeCensusReference(ReferenceKind, const void* ref);
+
+} // namespace JNI
+
+#if defined(ENABLE_REFERENCE_CENSUS)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define REFERENCE_CENSUS_CALLER() _ReturnAddress()
+#else
+#define REFERENCE_CENSUS_CALLER() __builtin_return_address(0)
+#endif
+#define REFERENCE_CENSUS_ADD(kind, ref) JNI::addCensusReference(JNI::ReferenceKind::kind, ref, REFERENCE_CENSUS_CALLER())
+#define REFERENCE_CENSUS_REMOVE(kind, ref) JNI::removeCensusReference(JNI::ReferenceKind::kind, ref)
+#else
+#define REFERENCE_CENSUS_ADD(kind, ref) ((void)0)
+#define REFERENCE_CENSUS_REMOVE(kind, ref) ((void)0)
+#endif
@@ -49,6 +49,8 @@ JNI_EXPORT void derefGlobal(ref_t);
 JNI_EXPORT bool isExpiredWeakGlobal(weak_t);
 JNI_EXPORT weak_t refWeakGlobal(ref_t);
 JNI_EXPORT void derefWeakGlobal(weak_t);
+// Returns a new local reference to the referent, or null if it has been collected.
+JNI_EXPORT ref_t promoteWeakGlobal(weak_t);
 
 JNI_EXPORT ref_t popLocalCallerObjectRef();
 JNI_EXPORT void pushLocalCallerObjectRef(ref_t);
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "GlobalRef.h"
+#include "LocalRef.h"
+
+namespace JNI {
+
+// Shares a single JNI global reference between all of its copies. Copies only
+// touch an atomic count; the global reference is deleted with the last owner.
+template<typename T>
+class SharedGlobalRef final {
+    struct ControlBlock;
+
+public:
+    SharedGlobalRef()
+        : m_block(nullptr)
+    {
+    }
+    SharedGlobalRef(std::nullptr_t)
+        : m_block(nullptr)
+    {
+    }
+    SharedGlobalRef(T* ptr) // For already bound NativeObjects.
+        : m_block(adopt(0, ptr))
+    {
+    }
+    SharedGlobalRef(ref_t oref, T* ptr)
+        : m_block(adopt(JNI::refGlobal(oref), ptr))
+    {
+    }
+    SharedGlobalRef(const SharedGlobalRef& ref)
+        : m_block(ref.m_block)
+    {
+        if (m_block)
+            m_block->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    SharedGlobalRef(SharedGlobalRef&& ref) noexcept
+        : m_block(ref.m_block)
+    {
+        ref.m_block = nullptr;
+    }
+    template<typename U> SharedGlobalRef(const GlobalRef<U>& ref)
+        : m_block(adopt(JNI::refGlobal(ref.get()), ref.template getPtr<T>()))
+    {
+    }
+    template<typename U> SharedGlobalRef(const LocalRef<U>& ref)
+        : m_block(adopt(JNI::refGlobal(ref.get()), ref.template getPtr<T>()))
+    {
+    }
+    template<typename U> SharedGlobalRef(const PassLocalRef<U>& ref)
+        : m_block(adopt(JNI::refGlobal(ref.get()), ref.template getPtr<T>()))
+    {
+        ref.derefIfNotNull();
+    }
+    ~SharedGlobalRef()
+    {
+        derefIfNotNull();
+    }
+
+    void reset() { derefIfNotNull(); }
+
+    ref_t get() const { return m_block ? m_block->ref : 0; }
+
+    T* getPtr() const
+    {
+        if (!m_block || !m_block->ptr)
+            return nullptr;
+
+        return JNI::getPtr<T>(m_block->ref, m_block->ptr);
+    }
+    template<typename U> U* getPtr() const { return JNI::getPtr<U>(get(), getPtr()); }
+
+    T& operator*() const { return *getPtr(); }
+    T* operator->() const { return getPtr(); }
+
+    bool operator!() const { return !get(); }
+
+    // This conversion operator allows implicit conversion to bool but not to other integer types.
+    typedef ControlBlock* (SharedGlobalRef::*UnspecifiedBoolType);
+    operator UnspecifiedBoolType() const { return get() ? &SharedGlobalRef::m_block : nullptr; }
+
+    // Number of SharedGlobalRef objects sharing the global reference.
+    int32_t useCount() const { return m_block ? m_block->refCount.load(std::memory_order_relaxed) : 0; }
+
+    SharedGlobalRef& operator=(const SharedGlobalRef&);
+    SharedGlobalRef& operator=(SharedGlobalRef&&);
+
+    void swap(SharedGlobalRef&);
+
+private:
+    template<typename U> friend class SharedGlobalRef;
+
+    struct ControlBlock {
+        std::atomic<int32_t> refCount;
+        ref_t ref;
+        T* ptr;
+    };
+
+    static ControlBlock* adopt(ref_t ref, T* ptr)
+    {
+        if (ptr) {
+            ptr->ref();
+
+            if (!ref)
+                ref = ptr->refGlobal();
+        }
+        if (!ref && !ptr)
+            return nullptr;
+
+        ControlBlock* block = new ControlBlock;
+        block->refCount.store(1, std::memory_order_relaxed);
+        block->ref = ref;
+        block->ptr = ptr;
+        return block;
+    }
+    void derefIfNotNull()
+    {
+        ControlBlock* block = nullptr;
+        std::swap(block, m_block);
+        if (!block || block->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        if (block->ref)
+            JNI::derefGlobal(block->ref);
+        if (block->ptr)
+            block->ptr->deref();
+        delete block;
+    }
+
+    ControlBlock* m_block;
+}; // class SharedGlobalRef
+
+template<typename T> inline SharedGlobalRef<T>& SharedGlobalRef<T>::operator=(const SharedGlobalRef& o)
+{
+    SharedGlobalRef ptr = o;
+    swap(ptr);
+    return *this;
+}
+
+template<typename T> inline SharedGlobalRef<T>& SharedGlobalRef<T>::operator=(SharedGlobalRef&& o)
+{
+    SharedGlobalRef ptr = std::move(o);
+    swap(ptr);
+    return *this;
+}
+
+template<class T> inline void SharedGlobalRef<T>::swap(SharedGlobalRef& o)
+{
+    std::swap(m_block, o.m_block);
+}
+
+template<class T> inline void swap(SharedGlobalRef<T>& a, SharedGlobalRef<T>& b)
+{
+    a.swap(b);
+}
+
+template<typename T, typename U> inline bool operator==(const SharedGlobalRef<T>& a, const SharedGlobalRef<U>& b)
+{
+    return a.getPtr() == b.getPtr();
+}
+
+template<typename T, typename U> inline bool operator!=(const SharedGlobalRef<T>& a, const SharedGlobalRef<U>& b)
+{
+    return a.getPtr() != b.getPtr();
+}
+
+} // namespace JNI
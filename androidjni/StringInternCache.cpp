@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "StringInternCache.h"
+
+namespace JNI {
+
+static const size_t internedStringsCapacity = 1024;
+
+StringInternCache::StringInternCache(size_t capacity)
+    : m_capacity(capacity ? capacity : 1)
+    , m_hand(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+    m_slots.reserve(m_capacity);
+    m_index.reserve(m_capacity);
+}
+
+// FNV-1a, which needs no copy of the characters.
+size_t StringInternCache::KeyHash::operator()(const Key& key) const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < key.length; ++i) {
+        hash ^= static_cast<uint8_t>(key.data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
+ref_t StringInternCache::findLocked(const Key& key)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+        return 0;
+
+    Slot& slot = m_slots[it->second];
+    slot.referenced = true;
+    return JNI::refLocal(slot.string);
+}
+
+ref_t StringInternCache::lookup(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ref_t string = findLocked(key);
+    if (string)
+        ++m_hits;
+    else
+        ++m_misses;
+    return string;
+}
+
+size_t StringInternCache::evictLocked(ref_t& evicted)
+{
+    while (m_slots[m_hand].referenced) {
+        m_slots[m_hand].referenced = false;
+        m_hand = (m_hand + 1) % m_slots.size();
+    }
+
+    size_t victim = m_hand;
+    m_hand = (m_hand + 1) % m_slots.size();
+
+    const std::string& value = m_slots[victim].value;
+    m_index.erase(m_index.find({ value.data(), value.size() }));
+    evicted = m_slots[victim].string;
+    ++m_evictions;
+    return victim;
+}
+
+ref_t StringInternCache::insert(const Key& key, ref_t string)
+{
+    if (!string)
+        return 0;
+
+    ref_t existing;
+    ref_t evicted = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Another thread may have interned the same contents since the lookup.
+        existing = findLocked(key);
+        if (!existing) {
+            size_t index;
+            if (m_slots.size() < m_capacity) {
+                index = m_slots.size();
+                m_slots.push_back(Slot());
+            } else
+                index = evictLocked(evicted);
+
+            // Assigning reuses the evicted entry's buffer when it is large enough.
+            Slot& slot = m_slots[index];
+            slot.value.assign(key.data, key.length);
+            slot.referenced = false;
+            slot.string = JNI::refGlobal(string);
+            m_index.emplace(Key { slot.value.data(), slot.value.size() }, index);
+        }
+    }
+
+    if (evicted)
+        JNI::derefGlobal(evicted);
+
+    if (existing) {
+        JNI::derefLocal(string);
+        return existing;
+    }
+    return string;
+}
+
+StringInternCacheStatistics StringInternCache::statistics()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return { m_capacity, m_slots.size(), m_hits, m_misses, m_evictions };
+}
+
+void StringInternCache::clear()
+{
+    std::vector<Slot> slots;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        slots.swap(m_slots);
+        m_slots.reserve(m_capacity);
+        m_index.clear();
+        m_hand = 0;
+    }
+
+    for (auto& slot : slots)
+        JNI::derefGlobal(slot.string);
+}
+
+StringInternCache& internedStrings()
+{
+    static StringInternCache* cache = new StringInternCache(internedStringsCapacity);
+    return *cache;
+}
+
+} // namespace JNI
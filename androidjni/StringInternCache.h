@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ReferenceFunctions.h"
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace JNI {
+
+struct StringInternCacheStatistics {
+    size_t capacity;
+    size_t size;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+// Maps string contents to global references of Java strings with the same
+// contents. Entries are evicted in CLOCK order once the cache is full. Callers
+// only ever get local references, so evicting an entry cannot invalidate a
+// reference in use.
+class JNI_EXPORT StringInternCache {
+public:
+    explicit StringInternCache(size_t capacity);
+
+    // Returns a new local reference to the string for the given contents, calling
+    // create() for a local reference to a new Java string on a miss. The contents
+    // are only copied when they are inserted.
+    template<typename Create> ref_t refLocal(const char* data, size_t length, Create create)
+    {
+        Key key = { data, length };
+        if (ref_t string = lookup(key))
+            return string;
+        return insert(key, create());
+    }
+    template<typename Create> ref_t refLocal(const std::string& value, Create create)
+    {
+        return refLocal(value.data(), value.size(), create);
+    }
+
+    StringInternCacheStatistics statistics();
+    void clear();
+
+private:
+    StringInternCache(const StringInternCache&) = delete;
+    StringInternCache& operator=(const StringInternCache&) = delete;
+
+    // Characters of a string, owned by the caller or by a slot.
+    struct Key {
+        const char* data;
+        size_t length;
+
+        bool operator==(const Key& other) const { return length == other.length && !memcmp(data, other.data, length); }
+    };
+    struct KeyHash {
+        size_t operator()(const Key&) const;
+    };
+
+    struct Slot {
+        std::string value; // Owns the characters of the entry's key in m_index.
+        bool referenced;
+        ref_t string;
+    };
+
+    ref_t lookup(const Key&);
+    ref_t insert(const Key&, ref_t string);
+    ref_t findLocked(const Key&);
+    size_t evictLocked(ref_t& evicted);
+
+    size_t m_capacity;
+    std::mutex m_mutex;
+    std::vector<Slot> m_slots; // Never grows past m_capacity, so the keys stay put.
+    std::unordered_map<Key, size_t, KeyHash> m_index;
+    size_t m_hand;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_evictions;
+}; // class StringInternCache
+
+// The cache toManaged() uses for InternedString values.
+JNI_EXPORT StringInternCache& internedStrings();
+
+} // namespace JNI
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "UTFConversion.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace JNI {
+
+// Operations on the UTF-16 code units of Java strings, for use on characters
+// pinned with GetStringCritical or copied with GetStringRegion. None of them
+// allocate. UTF-8 arguments are decoded like utf8ToUTF16() does.
+
+// Same value as java.lang.String.hashCode(), continued from the hash of any
+// preceding code units.
+JNI_EXPORT int32_t javaHashCode(const uint16_t* data, size_t length, int32_t hash = 0);
+
+JNI_EXPORT bool equalsUTF8(const uint16_t* data, size_t length, const char* string, size_t stringLength);
+JNI_EXPORT bool startsWithUTF8(const uint16_t* data, size_t length, const char* prefix, size_t prefixLength);
+
+// Index of the first occurrence at or after from, or -1, like java.lang.String.indexOf().
+JNI_EXPORT ptrdiff_t indexOf(const uint16_t* data, size_t length, uint16_t c, size_t from = 0);
+JNI_EXPORT ptrdiff_t indexOf(const uint16_t* data, size_t length, const uint16_t* needle, size_t needleLength, size_t from = 0);
+
+// Calls function(units, count) on the UTF-16 form of a UTF-8 string, a bounded
+// chunk at a time, until it returns false. Returns whether it always returned true.
+template<typename Function> bool forEachUTF16Chunk(const char* string, size_t length, Function function)
+{
+    static const size_t chunkLength = 64;
+    uint16_t units[chunkLength];
+    size_t start = 0;
+    while (start < length) {
+        size_t end = start + chunkLength < length ? start + chunkLength : length;
+        // Split before the lead byte of a sequence cut by the chunk boundary.
+        if (end < length) {
+            size_t lead = end;
+            while (lead > start && (static_cast<uint8_t>(string[lead]) & 0xC0) == 0x80)
+                --lead;
+            if (lead > start)
+                end = lead;
+        }
+        if (!function(static_cast<const uint16_t*>(units), utf8ToUTF16(string + start, end - start, units)))
+            return false;
+        start = end;
+    }
+    return true;
+}
+
+} // namespace JNI
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "UTFConversion.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define USE_NEON 1
+#endif
+
+namespace JNI {
+
+static const uint16_t replacementCharacter = 0xFFFD;
+
+static inline bool isLeadSurrogate(uint16_t c) { return (c & 0xFC00) == 0xD800; }
+static inline bool isTrailSurrogate(uint16_t c) { return (c & 0xFC00) == 0xDC00; }
+
+// Each of these returns the number of leading code units or bytes it converted,
+// a multiple of the vector width that stops before the first non-ASCII block.
+
+static inline size_t countASCII(const uint16_t* data, size_t length)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    for (; i + 8 <= length; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), _mm_setzero_si128())) != 0xFFFF)
+            break;
+    }
+#elif defined(USE_NEON)
+    const uint16x8_t mask = vdupq_n_u16(0xFF80);
+    for (; i + 8 <= length; i += 8) {
+        uint64x2_t high = vreinterpretq_u64_u16(vandq_u16(vld1q_u16(data + i), mask));
+        if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1))
+            break;
+    }
+#endif
+    return i;
+}
+
+static inline size_t narrowASCII(const uint16_t* data, size_t length, char* result)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    for (; i + 16 <= length; i += 16) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 8));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(low, high), mask), _mm_setzero_si128())) != 0xFFFF)
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm_packus_epi16(low, high));
+    }
+#elif defined(USE_NEON)
+    const uint16x8_t mask = vdupq_n_u16(0xFF80);
+    for (; i + 16 <= length; i += 16) {
+        uint16x8_t low = vld1q_u16(data + i);
+        uint16x8_t high = vld1q_u16(data + i + 8);
+        uint64x2_t bits = vreinterpretq_u64_u16(vandq_u16(vorrq_u16(low, high), mask));
+        if (vgetq_lane_u64(bits, 0) | vgetq_lane_u64(bits, 1))
+            break;
+        vst1q_u8(reinterpret_cast<uint8_t*>(result + i), vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+    }
+#endif
+    return i;
+}
+
+static inline size_t widenASCII(const uint8_t* data, size_t length, uint16_t* result)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (_mm_movemask_epi8(v))
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm_unpacklo_epi8(v, _mm_setzero_si128()));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i + 8), _mm_unpackhi_epi8(v, _mm_setzero_si128()));
+    }
+#elif defined(USE_NEON)
+    const uint8x16_t mask = vdupq_n_u8(0x80);
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t v = vld1q_u8(data + i);
+        uint64x2_t bits = vreinterpretq_u64_u8(vandq_u8(v, mask));
+        if (vgetq_lane_u64(bits, 0) | vgetq_lane_u64(bits, 1))
+            break;
+        vst1q_u16(result + i, vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(result + i + 8, vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+    return i;
+}
+
+size_t utf8Length(const uint16_t* data, size_t length)
+{
+    size_t result = 0;
+    size_t i = 0;
+    while (i < length) {
+        size_t ascii = countASCII(data + i, length - i);
+        result += ascii;
+        i += ascii;
+        if (i == length)
+            break;
+
+        uint16_t c = data[i++];
+        if (c < 0x80)
+            result += 1;
+        else if (c < 0x800)
+            result += 2;
+        else if (isLeadSurrogate(c) && i < length && isTrailSurrogate(data[i])) {
+            result += 4;
+            ++i;
+        } else
+            result += 3;
+    }
+    return result;
+}
+
+void utf16ToUTF8(const uint16_t* data, size_t length, char* result)
+{
+    uint8_t* out = reinterpret_cast<uint8_t*>(result);
+    size_t i = 0;
+    while (i < length) {
+        size_t ascii = narrowASCII(data + i, length - i, reinterpret_cast<char*>(out));
+        out += ascii;
+        i += ascii;
+        if (i == length)
+            break;
+
+        uint32_t c = data[i++];
+        if (c < 0x80) {
+            *out++ = static_cast<uint8_t>(c);
+            continue;
+        }
+        if (c < 0x800) {
+            *out++ = static_cast<uint8_t>(0xC0 | (c >> 6));
+            *out++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+            continue;
+        }
+        if (isLeadSurrogate(c) && i < length && isTrailSurrogate(data[i])) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (data[i++] - 0xDC00);
+            *out++ = static_cast<uint8_t>(0xF0 | (c >> 18));
+            *out++ = static_cast<uint8_t>(0x80 | ((c >> 12) & 0x3F));
+            *out++ = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+            continue;
+        }
+        if ((c & 0xF800) == 0xD800)
+            c = replacementCharacter;
+        *out++ = static_cast<uint8_t>(0xE0 | (c >> 12));
+        *out++ = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+        *out++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+    }
+}
+
+std::string utf16ToUTF8(const uint16_t* data, size_t length)
+{
+    std::string result(utf8Length(data, length), '\0');
+    if (!result.empty())
+        utf16ToUTF8(data, length, &result[0]);
+    return result;
+}
+
+static inline bool isContinuation(uint8_t c) { return (c & 0xC0) == 0x80; }
+
+size_t utf8ToUTF16(const char* data, size_t length, uint16_t* result)
+{
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+    uint16_t* out = result;
+    size_t i = 0;
+    while (i < length) {
+        size_t ascii = widenASCII(in + i, length - i, out);
+        out += ascii;
+        i += ascii;
+        if (i == length)
+            break;
+
+        uint32_t c = in[i];
+        if (c < 0x80) {
+            *out++ = static_cast<uint16_t>(c);
+            ++i;
+            continue;
+        }
+
+        // Malformed input consumes one byte and yields one U+FFFD, which keeps
+        // the output within length code units.
+        size_t available = length - i;
+        if (c >= 0xC2 && c <= 0xDF && available >= 2 && isContinuation(in[i + 1])) {
+            *out++ = static_cast<uint16_t>(((c & 0x1F) << 6) | (in[i + 1] & 0x3F));
+            i += 2;
+            continue;
+        }
+        if (c >= 0xE0 && c <= 0xEF && available >= 3 && isContinuation(in[i + 1]) && isContinuation(in[i + 2])) {
+            uint32_t scalar = ((c & 0x0F) << 12) | ((in[i + 1] & 0x3F) << 6) | (in[i + 2] & 0x3F);
+            if (scalar >= 0x800 && (scalar & 0xF800) != 0xD800) {
+                *out++ = static_cast<uint16_t>(scalar);
+                i += 3;
+                continue;
+            }
+        }
+        if (c >= 0xF0 && c <= 0xF4 && available >= 4 && isContinuation(in[i + 1]) && isContinuation(in[i + 2]) && isContinuation(in[i + 3])) {
+            uint32_t scalar = ((c & 0x07) << 18) | ((in[i + 1] & 0x3F) << 12) | ((in[i + 2] & 0x3F) << 6) | (in[i + 3] & 0x3F);
+            if (scalar >= 0x10000 && scalar <= 0x10FFFF) {
+                scalar -= 0x10000;
+                *out++ = static_cast<uint16_t>(0xD800 | (scalar >> 10));
+                *out++ = static_cast<uint16_t>(0xDC00 | (scalar & 0x3FF));
+                i += 4;
+                continue;
+            }
+        }
+        *out++ = replacementCharacter;
+        ++i;
+    }
+    return out - result;
+}
+
+} // namespace JNI
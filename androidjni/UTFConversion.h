@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JNIExportMacros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace JNI {
+
+// Converts between the UTF-16 of Java strings and standard UTF-8. Unlike the
+// modified UTF-8 of the JNI String UTF functions, U+0000 is a single zero byte
+// and supplementary characters are 4-byte sequences. Unpaired surrogates and
+// malformed UTF-8 are replaced with U+FFFD. Runs of ASCII are converted with
+// SSE2 or NEON where available.
+
+// Returns the number of bytes utf16ToUTF8() writes for the given code units.
+JNI_EXPORT size_t utf8Length(const uint16_t* data, size_t length);
+// Writes utf8Length(data, length) bytes to result.
+JNI_EXPORT void utf16ToUTF8(const uint16_t* data, size_t length, char* result);
+JNI_EXPORT std::string utf16ToUTF8(const uint16_t* data, size_t length);
+
+// Writes at most length code units to result and returns how many were written.
+JNI_EXPORT size_t utf8ToUTF16(const char* data, size_t length, uint16_t* result);
+
+} // namespace JNI
@@ -26,6 +26,7 @@
 #pragma once
 
 #include "PassLocalRef.h"
+#include <androidjni/LocalFrame.h>
 
 namespace JNI {
 
@@ -44,6 +45,10 @@ public:
         : m_ref(ref)
     {
     }
+    WeakGlobalRef(WeakGlobalRef&& ref) noexcept
+        : m_ref(ref.leak())
+    {
+    }
     template<typename U> WeakGlobalRef(const PassLocalRef<U>& ref)
         : m_ref(JNI::refWeakGlobal(ref.get()))
     {
@@ -79,18 +84,18 @@ public:
 
     PassLocalRef<T> tryPromote() const
     {
-        if (isExpired())
-            return PassLocalRef<T>();
-
-        return T::fromRef(JNI::refLocal(m_ref));
+        return tryPromote<T>();
     }
 
     template<typename U> PassLocalRef<U> tryPromote() const
     {
-        if (isExpired())
+        ref_t ref = JNI::promoteWeakGlobal(m_ref);
+        if (!ref) {
+            releaseIfNotNull();
             return PassLocalRef<U>();
+        }
 
-        return U::fromRef(JNI::refLocal(m_ref));
+        return U::fromRef(ref);
     }
 
     bool operator!() const { return isExpired(); }
@@ -99,12 +104,20 @@ public:
     typedef weak_t (WeakGlobalRef::*UnspecifiedBoolType);
     operator UnspecifiedBoolType() const { return !isExpired(); }
 
+    WeakGlobalRef& operator=(WeakGlobalRef&&);
     WeakGlobalRef& operator=(const PassLocalRef<T>&);
     template<typename U> WeakGlobalRef& operator=(const PassLocalRef<U>&);
 
     void swap(WeakGlobalRef&);
 
 private:
+    void releaseIfNotNull() const
+    {
+        if (m_ref) {
+            JNI::derefWeakGlobal(m_ref);
+            m_ref = 0;
+        }
+    }
     void derefIfNotNull()
     {
         if (m_ref) {
@@ -117,6 +130,13 @@ private:
     mutable weak_t m_ref;
 }; // class WeakGlobalRef
 
+template<typename T> inline WeakGlobalRef<T>& WeakGlobalRef<T>::operator=(WeakGlobalRef&& o)
+{
+    WeakGlobalRef ptr = std::move(o);
+    swap(ptr);
+    return *this;
+}
+
 template<typename T> inline WeakGlobalRef<T>& WeakGlobalRef<T>::operator=(const PassLocalRef<T>& o)
 {
     WeakGlobalRef ptr = o;
@@ -141,4 +161,22 @@ template<class T> inline void swap(WeakGlobalRef<T>& a, WeakGlobalRef<T>& b)
     a.swap(b);
 }
 
+// Calls function with a PassLocalRef for every weak reference in [first, last)
+// that is still alive, releasing the expired ones. Local references created by
+// the calls are freed together when it returns. Returns the number of calls made.
+template<typename Iterator, typename Function> inline size_t promoteAll(Iterator first, Iterator last, Function function)
+{
+    LocalFrame frame;
+    size_t promoted = 0;
+    for (; first != last; ++first) {
+        auto ref = first->tryPromote();
+        if (!ref)
+            continue;
+
+        function(std::move(ref));
+        ++promoted;
+    }
+    return promoted;
+}
+
 } // namespace JNI
@@ -40,6 +40,14 @@
 #define NewStringArray NewObjectArray
 #define GetStringArrayElement GetObjectArrayElement
 #define SetStringArrayElement SetObjectArrayElement
+#define GetByteBufferField GetObjectField
+#define SetByteBufferField SetObjectField
+#define GetStaticByteBufferField GetStaticObjectField
+#define SetStaticByteBufferField SetStaticObjectField
+#define CallByteBufferMethod CallObjectMethod
+#define CallStaticByteBufferMethod CallStaticObjectMethod
 
 class _jstringArray : public _jarray {};
 typedef _jstringArray *jstringArray;
+class _jbytebuffer : public _jobject {};
+typedef _jbytebuffer *jbytebuffer;
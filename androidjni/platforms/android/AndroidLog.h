@@ -26,12 +26,13 @@
 #ifndef ONIG_AndroidLog_h
 #define ONIG_AndroidLog_h
 
-#include <android/log.h>
-
 #ifndef LOG_TAG
 #define LOG_TAG "JavaJNI"
 #endif
 
+#if defined(ANDROID) || defined(__ANDROID__)
+#include <android/log.h>
+
 #ifndef ALOGD
 #define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #endif
@@ -39,6 +40,18 @@
 #ifndef ALOGE
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 #endif
+#else
+// Host builds against a desktop JVM log to stderr.
+#include <stdio.h>
+
+#ifndef ALOGD
+#define ALOGD(...) (fprintf(stderr, "D/%s: ", LOG_TAG), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+#endif
+
+#ifndef ALOGE
+#define ALOGE(...) (fprintf(stderr, "E/%s: ", LOG_TAG), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+#endif
+#endif
 
 #ifndef ALOG_ASSERT
 #define ALOG_ASSERT(env, ...) ALOGE(__VA_ARGS__)
@@ -25,17 +25,66 @@
 
 #include "JavaVM.h"
 
+#include <androidjni/DirectBuffer.h>
+#include <androidjni/InternedString.h>
+#include <androidjni/StringInternCache.h>
+#include <androidjni/UTFConversion.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <dlfcn.h>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace JNI {
 
+// Cached per-thread JNIEnv. getEnv() only takes the slow path when this is null,
+// which is on the first call of each thread and after the thread is detached.
+// Only envs of threads this library attached, or envs installed by ScopedEnv, are
+// cached; a thread attached by someone else may be detached behind our back, so
+// its env is looked up with GetEnv on every call.
+static thread_local JNIEnv* currentThreadEnv = nullptr;
+
+static std::atomic<AttachPolicy> defaultAttachPolicy(AttachPolicy::Sticky);
+static thread_local bool hasCurrentThreadAttachPolicy = false;
+static thread_local AttachPolicy currentThreadAttachPolicy = AttachPolicy::Sticky;
+
+static std::atomic<uint64_t> attachCount(0);
+static std::atomic<uint64_t> detachCount(0);
+static std::atomic<uint64_t> attachNanoseconds(0);
+
+// The NDK declares the JNIEnv out-parameters of AttachCurrentThread() as JNIEnv**,
+// while desktop JDKs declare them as void**. This converts to either.
+class EnvOutParameter {
+public:
+    explicit EnvOutParameter(JNIEnv** env)
+        : m_env(env)
+    { }
+
+    operator JNIEnv**() const { return m_env; }
+    operator void**() const { return reinterpret_cast<void**>(m_env); }
+
+private:
+    JNIEnv** m_env;
+};
+
+static void detachCurrentThread()
+{
+    currentThreadEnv = nullptr;
+
+    JavaVM* jvm = getVM();
+    if (jvm && jvm->DetachCurrentThread() == JNI_OK)
+        detachCount.fetch_add(1, std::memory_order_relaxed);
+}
+
 class ThreadDestructor {
 public:
     static ThreadDestructor* get();
 
     void setAttached() { m_attached = true; }
+    void setDetached() { m_attached = false; }
 
 private:
     ThreadDestructor()
@@ -49,9 +98,7 @@ private:
         // We need to explicitly call DetachCurrentThread() before exiting the thread.
         // Otherwise, dalvikvm bug checks and aborts: "thread exiting, not yet detached".
         // It is harmless to call DetachCurrentThread() when we have not called AttachCurrentThread().
-        JavaVM* jvm = getVM();
-        if (jvm)
-            jvm->DetachCurrentThread();
+        detachCurrentThread();
     }
 
     static void destroy(void*);
@@ -82,7 +129,7 @@ void ThreadDestructor::destroy(void* data)
     delete destructor;
 }
 
-JNIEnv* getEnv()
+static JNIEnv* attachCurrentThread(const char* name, bool asDaemon)
 {
     union {
         JNIEnv* env;
@@ -90,9 +137,23 @@ JNIEnv* getEnv()
     } u;
     jint jniError = 0;
 
-    jniError = getVM()->AttachCurrentThread(&u.env, 0);
+    JavaVMAttachArgs args;
+    args.version = JNI_VERSION_1_6;
+    args.name = const_cast<char*>(name);
+    args.group = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    if (asDaemon)
+        jniError = getVM()->AttachCurrentThreadAsDaemon(EnvOutParameter(&u.env), name ? &args : 0);
+    else
+        jniError = getVM()->AttachCurrentThread(EnvOutParameter(&u.env), name ? &args : 0);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    attachNanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+
     if (jniError == JNI_OK) {
+        attachCount.fetch_add(1, std::memory_order_relaxed);
         ThreadDestructor::get()->setAttached();
+        currentThreadEnv = u.env;
         return u.env;
     }
 
@@ -100,24 +161,159 @@ JNIEnv* getEnv()
     return 0;
 }
 
+// The env of a thread attached by the VM or by someone else. It is not cached, since
+// we do not see such threads detach, and the thread is not ours to detach at exit.
+static JNIEnv* foreignThreadEnv()
+{
+    union {
+        JNIEnv* env;
+        void* dummy;
+    } u;
+    JavaVM* jvm = getVM();
+    if (jvm && jvm->GetEnv(&u.dummy, JNI_VERSION_1_6) == JNI_OK)
+        return u.env;
+    return 0;
+}
+
+JNIEnv* getEnv()
+{
+    JNIEnv* env = currentThreadEnv;
+    if (env)
+        return env;
+
+    env = foreignThreadEnv();
+    if (env)
+        return env;
+
+    AttachPolicy policy = hasCurrentThreadAttachPolicy ? currentThreadAttachPolicy : defaultAttachPolicy.load(std::memory_order_relaxed);
+    switch (policy) {
+    case AttachPolicy::Sticky:
+        return attachCurrentThread(0, false);
+    case AttachPolicy::Daemon:
+        return attachCurrentThread(0, true);
+    case AttachPolicy::Scoped:
+        break;
+    }
+
+    ALOGE("getEnv() called on an unattached thread without a JNI::ScopedAttach");
+    return 0;
+}
+
+JNIEnv* attachCurrentThreadAsDaemon(const char* name)
+{
+    JNIEnv* env = currentThreadEnv;
+    if (env)
+        return env;
+
+    env = foreignThreadEnv();
+    if (env)
+        return env;
+
+    return attachCurrentThread(name, true);
+}
+
+void setAttachPolicy(AttachPolicy policy)
+{
+    defaultAttachPolicy.store(policy, std::memory_order_relaxed);
+}
+
+void setCurrentThreadAttachPolicy(AttachPolicy policy)
+{
+    hasCurrentThreadAttachPolicy = true;
+    currentThreadAttachPolicy = policy;
+}
+
+AttachStatistics attachStatistics()
+{
+    AttachStatistics statistics;
+    statistics.attachCount = attachCount.load(std::memory_order_relaxed);
+    statistics.detachCount = detachCount.load(std::memory_order_relaxed);
+    statistics.attachNanoseconds = attachNanoseconds.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+ScopedAttach::ScopedAttach(const char* name)
+    : m_env(currentThreadEnv)
+    , m_attached(false)
+{
+    if (m_env)
+        return;
+
+    m_env = foreignThreadEnv();
+    if (m_env)
+        return;
+
+    m_env = attachCurrentThread(name, false);
+    m_attached = m_env != nullptr;
+}
+
+ScopedAttach::~ScopedAttach()
+{
+    if (!m_attached)
+        return;
+
+    ThreadDestructor::get()->setDetached();
+    detachCurrentThread();
+}
+
+ScopedEnv::ScopedEnv(JNIEnv* env)
+    : m_previousEnv(currentThreadEnv)
+{
+    currentThreadEnv = env;
+}
+
+ScopedEnv::~ScopedEnv()
+{
+    currentThreadEnv = m_previousEnv;
+}
+
 #if !defined(WIN32)
 // Code from Webkit (https://webkit.org/) under LGPL v2 and BSD licenses (https://webkit.org/licensing-webkit/)
 static jint KJSGetCreatedJavaVMs(JavaVM** vmBuf, jsize bufLen, jsize* nVMs)
 {
-    static void* javaVMFramework = 0;
-    if (!javaVMFramework)
-        javaVMFramework = dlopen("/System/Library/Frameworks/JavaVM.framework/JavaVM", RTLD_LAZY);
-    if (!javaVMFramework)
-        return JNI_ERR;
-
     typedef jint(*FunctionPointerType)(JavaVM**, jsize, jsize*);
     static FunctionPointerType functionPointer = 0;
+
+    // A libjvm already loaded into the process, e.g. when running under a desktop java launcher.
     if (!functionPointer)
+        functionPointer = reinterpret_cast<FunctionPointerType>(dlsym(RTLD_DEFAULT, "JNI_GetCreatedJavaVMs"));
+
+    if (!functionPointer) {
+        static void* javaVMFramework = 0;
+        if (!javaVMFramework)
+            javaVMFramework = dlopen("/System/Library/Frameworks/JavaVM.framework/JavaVM", RTLD_LAZY);
+        if (!javaVMFramework)
+            return JNI_ERR;
+
         functionPointer = reinterpret_cast<FunctionPointerType>(dlsym(javaVMFramework, "JNI_GetCreatedJavaVMs"));
+    }
     if (!functionPointer)
         return JNI_ERR;
     return functionPointer(vmBuf, bufLen, nVMs);
 }
+
+static void* openJVMLibrary(const char* libraryPath)
+{
+    if (libraryPath)
+        return dlopen(libraryPath, RTLD_NOW | RTLD_GLOBAL);
+
+    const char* javaHome = getenv("JAVA_HOME");
+    if (javaHome) {
+        static const char* const candidates[] = {
+            "/lib/server/libjvm.so",
+            "/jre/lib/server/libjvm.so",
+            "/jre/lib/amd64/server/libjvm.so",
+            "/jre/lib/aarch64/server/libjvm.so",
+        };
+        for (const char* candidate : candidates) {
+            void* library = dlopen((std::string(javaHome) + candidate).c_str(), RTLD_NOW | RTLD_GLOBAL);
+            if (library)
+                return library;
+        }
+    }
+
+    return dlopen("libjvm.so", RTLD_NOW | RTLD_GLOBAL);
+}
 #endif
 
 static JavaVM* jvm = 0;
@@ -131,6 +327,60 @@ void setVM(JavaVM* javaVM)
     jvm = javaVM;
 }
 
+JavaVM* loadVM(const char* libraryPath, const std::vector<std::string>& options)
+{
+#if !defined(WIN32)
+    void* library = openJVMLibrary(libraryPath);
+    if (!library) {
+        ALOGE("Failed to load libjvm: %s", dlerror());
+        return 0;
+    }
+
+    typedef jint(*GetCreatedJavaVMsType)(JavaVM**, jsize, jsize*);
+    typedef jint(*CreateJavaVMType)(JavaVM**, void**, void*);
+    GetCreatedJavaVMsType getCreatedJavaVMs = reinterpret_cast<GetCreatedJavaVMsType>(dlsym(library, "JNI_GetCreatedJavaVMs"));
+    CreateJavaVMType createJavaVM = reinterpret_cast<CreateJavaVMType>(dlsym(library, "JNI_CreateJavaVM"));
+    if (!getCreatedJavaVMs || !createJavaVM) {
+        ALOGE("libjvm does not export the JNI invocation API");
+        return 0;
+    }
+
+    JavaVM* javaVM = 0;
+    jsize nJVMs = 0;
+    if (getCreatedJavaVMs(&javaVM, 1, &nJVMs) == JNI_OK && nJVMs > 0) {
+        setVM(javaVM);
+        return javaVM;
+    }
+
+    std::vector<JavaVMOption> vmOptions(options.size());
+    for (size_t i = 0; i < options.size(); ++i) {
+        vmOptions[i].optionString = const_cast<char*>(options[i].c_str());
+        vmOptions[i].extraInfo = 0;
+    }
+
+    JavaVMInitArgs args;
+    args.version = JNI_VERSION_1_6;
+    args.nOptions = static_cast<jint>(vmOptions.size());
+    args.options = vmOptions.data();
+    args.ignoreUnrecognized = JNI_FALSE;
+
+    JNIEnv* env = 0;
+    jint jniError = createJavaVM(&javaVM, reinterpret_cast<void**>(&env), &args);
+    if (jniError != JNI_OK) {
+        ALOGE("JNI_CreateJavaVM failed, returned %ld", static_cast<long>(jniError));
+        return 0;
+    }
+
+    // JNI_CreateJavaVM() attaches the creating thread; it stays attached like the VM's main thread.
+    currentThreadEnv = env;
+    setVM(javaVM);
+    return javaVM;
+#else
+    ALOGE("loadVM is not supported on this platform");
+    return 0;
+#endif
+}
+
 JavaVM* getVM()
 {
     if (jvm)
@@ -152,23 +402,99 @@ JavaVM* getVM()
     return jvm;
 }
 
+// Strings up to this many code units are converted through a stack buffer.
+static const size_t stringStackBufferLength = 256;
+
+static jstring newString(JNIEnv* env, const char* data, size_t length)
+{
+    if (length <= stringStackBufferLength) {
+        jchar chars[stringStackBufferLength];
+        return env->NewString(chars, utf8ToUTF16(data, length, chars));
+    }
+
+    std::vector<jchar> chars(length);
+    return env->NewString(chars.data(), utf8ToUTF16(data, length, chars.data()));
+}
+
+jstring toManaged(JNIEnv* env, const std::string& value)
+{
+    return newString(env, value.data(), value.size());
+}
+
 jstring toManaged(const std::string& value)
 {
-    return getEnv()->NewStringUTF(value.data());
+    return toManaged(getEnv(), value);
 }
 
-std::string toNative(jstring str)
+std::string toNative(JNIEnv* env, jstring str)
 {
     if (!str)
         return std::string();
 
-    const char* chars = getEnv()->GetStringUTFChars(str, NULL);
+    size_t length = env->GetStringLength(str);
+    if (length <= stringStackBufferLength) {
+        jchar chars[stringStackBufferLength];
+        env->GetStringRegion(str, 0, length, chars);
+        return utf16ToUTF8(chars, length);
+    }
+
+    // Transcoding makes no JNI calls, so the characters can stay pinned meanwhile.
+    const jchar* chars = env->GetStringCritical(str, NULL);
     if (!chars)
         return std::string();
 
-    std::string nativeString(chars);
-    getEnv()->ReleaseStringUTFChars(str, chars);
+    std::string nativeString = utf16ToUTF8(chars, length);
+    env->ReleaseStringCritical(str, chars);
     return nativeString;
 }
 
+std::string toNative(jstring str)
+{
+    return toNative(getEnv(), str);
+}
+
+jstring toManaged(JNIEnv* env, const InternedString& value)
+{
+    return reinterpret_cast<jstring>(internedStrings().refLocal(value.data(), value.size(), [&] {
+        return reinterpret_cast<ref_t>(newString(env, value.data(), value.size()));
+    }));
+}
+
+jstring toManaged(const InternedString& value)
+{
+    return toManaged(getEnv(), value);
+}
+
+jbytebuffer toManaged(JNIEnv* env, const DirectBuffer& buffer)
+{
+    if (!buffer.data())
+        return 0;
+
+    return reinterpret_cast<jbytebuffer>(env->NewDirectByteBuffer(buffer.data(), buffer.size()));
+}
+
+jbytebuffer toManaged(const DirectBuffer& buffer)
+{
+    return toManaged(getEnv(), buffer);
+}
+
+DirectBuffer toNative(JNIEnv* env, jbytebuffer buffer)
+{
+    if (!buffer)
+        return DirectBuffer();
+
+    void* address = env->GetDirectBufferAddress(buffer);
+    if (!address) {
+        ALOGE("GetDirectBufferAddress failed, the buffer is not direct");
+        return DirectBuffer();
+    }
+
+    return DirectBuffer(address, env->GetDirectBufferCapacity(buffer));
+}
+
+DirectBuffer toNative(jbytebuffer buffer)
+{
+    return toNative(getEnv(), buffer);
+}
+
 }
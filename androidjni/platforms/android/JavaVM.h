@@ -28,10 +28,80 @@
 #include "AndroidJNI.h"
 #include "AndroidLog.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace JNI {
 
 JNI_EXPORT JNIEnv* getEnv();
 JNI_EXPORT JavaVM* getVM();
 JNI_EXPORT void setVM(JavaVM*);
 
+// Loads libjvm.so and installs the VM it is already running, or creates one with
+// the given options (e.g. "-Djava.class.path=..."). When libraryPath is null, the
+// library is looked up under $JAVA_HOME and then on the default search path.
+// This lets the JNI backend run on a desktop OpenJDK.
+JNI_EXPORT JavaVM* loadVM(const char* libraryPath, const std::vector<std::string>& options);
+
+// Attaches the calling thread as a daemon under the given name. The thread stays
+// attached until it exits. Returns the current env if the thread is already attached.
+JNI_EXPORT JNIEnv* attachCurrentThreadAsDaemon(const char* name);
+
+// How getEnv() treats a thread that is not attached yet:
+//  Sticky - attach it and keep it attached until the thread exits (the default).
+//  Daemon - same as Sticky, but attach as a daemon thread.
+//  Scoped - do not attach; the caller must hold a ScopedAttach.
+// Under every policy, threads attached by the VM or by someone else are resolved
+// with GetEnv on every call and are never detached by this library.
+enum class AttachPolicy {
+    Sticky,
+    Scoped,
+    Daemon,
+};
+
+JNI_EXPORT void setAttachPolicy(AttachPolicy);
+JNI_EXPORT void setCurrentThreadAttachPolicy(AttachPolicy);
+
+struct AttachStatistics {
+    uint64_t attachCount;
+    uint64_t detachCount;
+    uint64_t attachNanoseconds;
+};
+
+// Process-wide totals since startup.
+JNI_EXPORT AttachStatistics attachStatistics();
+
+// Attaches the current thread for the lifetime of the object. Detaches on
+// destruction only if this object did the attach.
+class JNI_EXPORT ScopedAttach final {
+public:
+    explicit ScopedAttach(const char* name = nullptr);
+    ~ScopedAttach();
+
+    JNIEnv* env() const { return m_env; }
+
+private:
+    ScopedAttach(const ScopedAttach&) = delete;
+    ScopedAttach& operator=(const ScopedAttach&) = delete;
+
+    JNIEnv* m_env;
+    bool m_attached;
+};
+
+// Installs the JNIEnv handed to a native method as the current thread's env for
+// the duration of the call. getEnv() inside the call is then a thread-local load
+// that never reaches GetEnv or AttachCurrentThread.
+class JNI_EXPORT ScopedEnv final {
+public:
+    explicit ScopedEnv(JNIEnv*);
+    ~ScopedEnv();
+
+private:
+    ScopedEnv(const ScopedEnv&) = delete;
+    ScopedEnv& operator=(const ScopedEnv&) = delete;
+
+    JNIEnv* m_previousEnv;
+};
+
 }
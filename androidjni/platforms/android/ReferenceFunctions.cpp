@@ -25,6 +25,8 @@
 
 #include "androidjni/ReferenceFunctions.h"
 
+#include "androidjni/ReferenceCensus.h"
+
 #include "JavaVM.h"
 
 namespace JNI {
@@ -34,7 +36,9 @@ ref_t refLocal(ref_t ref)
     if (!ref)
         return 0;
 
-    return CALL_JNI(NewLocalRef, ref);
+    ref_t local = CALL_JNI(NewLocalRef, ref);
+    REFERENCE_CENSUS_ADD(Local, local);
+    return local;
 }
 
 void derefLocal(ref_t ref)
@@ -42,6 +46,7 @@ void derefLocal(ref_t ref)
     if (!ref)
         return;
 
+    REFERENCE_CENSUS_REMOVE(Local, ref);
     CALL_JNI(DeleteLocalRef, ref);
 }
 
@@ -50,7 +55,9 @@ ref_t refGlobal(ref_t ref)
     if (!ref)
         return 0;
 
-    return CALL_JNI(NewGlobalRef, ref);
+    ref_t global = CALL_JNI(NewGlobalRef, ref);
+    REFERENCE_CENSUS_ADD(Global, global);
+    return global;
 }
 
 void derefGlobal(ref_t ref)
@@ -58,6 +65,7 @@ void derefGlobal(ref_t ref)
     if (!ref)
         return;
 
+    REFERENCE_CENSUS_REMOVE(Global, ref);
     CALL_JNI(DeleteGlobalRef, ref);
 }
 
@@ -75,6 +83,7 @@ weak_t refWeakGlobal(ref_t ref)
         return 0;
 
     jweak weak = CALL_JNI(NewWeakGlobalRef, ref);
+    REFERENCE_CENSUS_ADD(WeakGlobal, weak);
     return reinterpret_cast<weak_t>(weak);
 }
 
@@ -83,42 +92,18 @@ void derefWeakGlobal(weak_t ref)
     if (!ref)
         return;
 
+    REFERENCE_CENSUS_REMOVE(WeakGlobal, ref);
     CALL_JNI(DeleteWeakGlobalRef, ref);
 }
 
-struct LocalCallerObject {
-    ref_t oref;
-    LocalCallerObject* next;
-};
-
-static thread_local LocalCallerObject localCallerObjects;
-
-ref_t popLocalCallerObjectRef()
+ref_t promoteWeakGlobal(weak_t ref)
 {
-    ref_t ref = 0;
-    std::swap(ref, localCallerObjects.oref);
-
-    if (!localCallerObjects.next)
-        return ref;
-
-    std::unique_ptr<LocalCallerObject> next(localCallerObjects.next);
-    localCallerObjects.oref = next->oref;
-    localCallerObjects.next = next->next;
-    return ref;
-}
-
-void pushLocalCallerObjectRef(ref_t ref)
-{
-    if (!localCallerObjects.oref) {
-        localCallerObjects.oref = ref;
-        return;
-    }
+    if (!ref)
+        return 0;
 
-    LocalCallerObject* next = new LocalCallerObject;
-    next->oref = localCallerObjects.oref;
-    next->next = localCallerObjects.next;
-    localCallerObjects.oref = ref;
-    localCallerObjects.next = next;
+    ref_t local = CALL_JNI(NewLocalRef, ref);
+    REFERENCE_CENSUS_ADD(Local, local);
+    return local;
 }
 
 } // namespace JNI
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <deque>
+#include <pthread.h>
+#include <thread>
+
+namespace JNI {
+
+struct ThreadPool::Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    std::atomic<uint64_t> executedCount { 0 };
+    std::atomic<uint64_t> stealCount { 0 };
+    std::thread thread;
+};
+
+// Lets post() from inside a task push to the calling worker's own queue.
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local size_t currentWorkerIndex = 0;
+
+ThreadPool::ThreadPool(size_t workerCount, const char* name)
+    : m_workerCount(workerCount ? workerCount : std::max(1u, std::thread::hardware_concurrency()))
+    , m_name(name ? name : "jni-worker")
+    , m_workers(new std::unique_ptr<Worker>[m_workerCount])
+    , m_nextWorker(0)
+    , m_pendingTasks(0)
+    , m_sleepingWorkers(0)
+    , m_stopping(false)
+{
+    for (size_t i = 0; i < m_workerCount; ++i)
+        m_workers[i].reset(new Worker);
+    for (size_t i = 0; i < m_workerCount; ++i)
+        m_workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_stopping = true;
+    }
+    m_idleCondition.notify_all();
+
+    for (size_t i = 0; i < m_workerCount; ++i)
+        m_workers[i]->thread.join();
+}
+
+void ThreadPool::post(Task task)
+{
+    size_t index = (currentPool == this) ? currentWorkerIndex : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workerCount;
+
+    // Counted before it is queued, so a worker never dequeues a task the count does not include.
+    m_pendingTasks.fetch_add(1, std::memory_order_seq_cst);
+    {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    // Pairs with run(): either a worker about to sleep sees the new count, or it is counted as sleeping here
+    // and taking the mutex orders the notification after its wait began.
+    if (m_sleepingWorkers.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idleCondition.notify_one();
+    }
+}
+
+std::vector<ThreadPool::WorkerStatistics> ThreadPool::statistics() const
+{
+    std::vector<WorkerStatistics> result(m_workerCount);
+    for (size_t i = 0; i < m_workerCount; ++i) {
+        Worker& worker = *m_workers[i];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            result[i].queueDepth = worker.tasks.size();
+        }
+        result[i].executedCount = worker.executedCount.load(std::memory_order_relaxed);
+        result[i].stealCount = worker.stealCount.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void ThreadPool::run(size_t index)
+{
+    std::string threadName = m_name + '-' + std::to_string(index);
+    pthread_setname_np(pthread_self(), threadName.substr(0, 15).c_str());
+    attachCurrentThreadAsDaemon(threadName.c_str());
+
+    currentPool = this;
+    currentWorkerIndex = index;
+
+    Worker& worker = *m_workers[index];
+    while (true) {
+        Task task;
+        if (popTask(index, task) || stealTask(index, task)) {
+            m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            worker.executedCount.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        m_idleCondition.wait(lock, [this] { return m_stopping || m_pendingTasks.load(std::memory_order_seq_cst); });
+        m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        if (m_stopping && !m_pendingTasks.load(std::memory_order_relaxed))
+            break;
+    }
+
+    currentPool = nullptr;
+}
+
+bool ThreadPool::popTask(size_t index, Task& task)
+{
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty())
+        return false;
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::stealTask(size_t index, Task& task)
+{
+    for (size_t i = 1; i < m_workerCount; ++i) {
+        Worker& victim = *m_workers[(index + i) % m_workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty())
+            continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        m_workers[index]->stealCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JavaVM.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace JNI {
+
+// Work-stealing pool of threads that attach to the VM once, as named daemons,
+// and stay attached for their lifetime. Tasks may freely use JNI references.
+class JNI_EXPORT ThreadPool final {
+public:
+    typedef std::function<void()> Task;
+
+    struct WorkerStatistics {
+        size_t queueDepth;
+        uint64_t executedCount;
+        uint64_t stealCount;
+    };
+
+    // A workerCount of 0 uses std::thread::hardware_concurrency().
+    // Thread names are "<name>-<index>" and are truncated to 15 characters.
+    explicit ThreadPool(size_t workerCount = 0, const char* name = "jni-worker");
+    // Runs the remaining tasks and joins the workers.
+    ~ThreadPool();
+
+    void post(Task);
+
+    size_t workerCount() const { return m_workerCount; }
+    std::vector<WorkerStatistics> statistics() const;
+
+private:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    struct Worker;
+
+    void run(size_t index);
+    bool popTask(size_t index, Task&);
+    bool stealTask(size_t index, Task&);
+
+    size_t m_workerCount;
+    std::string m_name;
+    std::unique_ptr<std::unique_ptr<Worker>[]> m_workers;
+    std::atomic<size_t> m_nextWorker;
+
+    // Posting and dequeuing only touch the counters; the mutex guards sleeping and waking.
+    std::atomic<size_t> m_pendingTasks;
+    std::atomic<size_t> m_sleepingWorkers;
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCondition;
+    bool m_stopping;
+};
+
+}
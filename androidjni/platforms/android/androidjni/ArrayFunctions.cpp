@@ -25,10 +25,20 @@
 
 #include "androidjni/PassArray.h"
 
+#include "androidjni/LocalFrame.h"
+
 #include "JavaVM.h"
 
+#include <androidjni/UTFConversion.h>
+
+#include <algorithm>
+#include <vector>
+
 namespace JNI {
 
+// Element loops create local references in frames of this many elements.
+static const size_t localFrameChunkSize = 64;
+
 void deleteArrayObject(ref_t arrayObject)
 {
     if (arrayObject)
@@ -39,6 +49,7 @@ size_t getArrayObjectElementsCount(ref_t arrayObject)
 {
     if (arrayObject)
         return getEnv()->GetArrayLength(reinterpret_cast<jarray>(arrayObject));
+    return 0;
 }
 
 ref_t newIntArrayObject(const int32_t* data, size_t count)
@@ -47,11 +58,8 @@ ref_t newIntArrayObject(const int32_t* data, size_t count)
     if (!arrayObject)
         return 0;
 
-    jint* arrayElements = getEnv()->GetIntArrayElements(arrayObject, NULL);
-    if (arrayElements) {
-        memcpy(arrayElements, data, sizeof(jint) * count);
-        getEnv()->ReleaseIntArrayElements(arrayObject, arrayElements, 0);
-    }
+    if (count)
+        getEnv()->SetIntArrayRegion(arrayObject, 0, count, data);
 
     return arrayObject;
 }
@@ -61,12 +69,23 @@ int32_t* getIntArrayElements(ref_t arrayObject)
     return getEnv()->GetIntArrayElements(reinterpret_cast<jintArray>(arrayObject), NULL);
 }
 
-void releaseIntArrayElements(ref_t arrayObject, int32_t* data, size_t)
+void releaseIntArrayElements(ref_t arrayObject, int32_t* data, size_t, bool commit)
 {
     if (!data)
         return;
 
-    getEnv()->ReleaseIntArrayElements(reinterpret_cast<jintArray>(arrayObject), data, 0);
+    // JNI_ABORT frees the elements without copying them back into the array.
+    getEnv()->ReleaseIntArrayElements(reinterpret_cast<jintArray>(arrayObject), data, commit ? 0 : JNI_ABORT);
+}
+
+void getIntArrayRegion(ref_t arrayObject, size_t start, size_t count, int32_t* data)
+{
+    getEnv()->GetIntArrayRegion(reinterpret_cast<jintArray>(arrayObject), start, count, data);
+}
+
+void setIntArrayRegion(ref_t arrayObject, size_t start, size_t count, const int32_t* data)
+{
+    getEnv()->SetIntArrayRegion(reinterpret_cast<jintArray>(arrayObject), start, count, data);
 }
 
 ref_t newShortArrayObject(const int16_t* data, size_t count)
@@ -75,11 +94,8 @@ ref_t newShortArrayObject(const int16_t* data, size_t count)
     if (!arrayObject)
         return 0;
 
-    jshort* arrayElements = getEnv()->GetShortArrayElements(arrayObject, NULL);
-    if (arrayElements) {
-        memcpy(arrayElements, data, sizeof(jshort) * count);
-        getEnv()->ReleaseShortArrayElements(arrayObject, arrayElements, 0);
-    }
+    if (count)
+        getEnv()->SetShortArrayRegion(arrayObject, 0, count, data);
 
     return arrayObject;
 }
@@ -89,12 +105,22 @@ int16_t* getShortArrayElements(ref_t arrayObject)
     return getEnv()->GetShortArrayElements(reinterpret_cast<jshortArray>(arrayObject), NULL);
 }
 
-void releaseShortArrayElements(ref_t arrayObject, int16_t* data, size_t)
+void releaseShortArrayElements(ref_t arrayObject, int16_t* data, size_t, bool commit)
 {
     if (!data)
         return;
 
-    getEnv()->ReleaseShortArrayElements(reinterpret_cast<jshortArray>(arrayObject), data, 0);
+    getEnv()->ReleaseShortArrayElements(reinterpret_cast<jshortArray>(arrayObject), data, commit ? 0 : JNI_ABORT);
+}
+
+void getShortArrayRegion(ref_t arrayObject, size_t start, size_t count, int16_t* data)
+{
+    getEnv()->GetShortArrayRegion(reinterpret_cast<jshortArray>(arrayObject), start, count, data);
+}
+
+void setShortArrayRegion(ref_t arrayObject, size_t start, size_t count, const int16_t* data)
+{
+    getEnv()->SetShortArrayRegion(reinterpret_cast<jshortArray>(arrayObject), start, count, data);
 }
 
 ref_t newByteArrayObject(const int8_t* data, size_t count)
@@ -103,11 +129,8 @@ ref_t newByteArrayObject(const int8_t* data, size_t count)
     if (!arrayObject)
         return 0;
 
-    jbyte* arrayElements = getEnv()->GetByteArrayElements(arrayObject, NULL);
-    if (arrayElements) {
-        memcpy(arrayElements, data, sizeof(jbyte) * count);
-        getEnv()->ReleaseByteArrayElements(arrayObject, arrayElements, 0);
-    }
+    if (count)
+        getEnv()->SetByteArrayRegion(arrayObject, 0, count, data);
 
     return arrayObject;
 }
@@ -117,12 +140,22 @@ int8_t* getByteArrayElements(ref_t arrayObject)
     return getEnv()->GetByteArrayElements(reinterpret_cast<jbyteArray>(arrayObject), NULL);
 }
 
-void releaseByteArrayElements(ref_t arrayObject, int8_t* data, size_t)
+void releaseByteArrayElements(ref_t arrayObject, int8_t* data, size_t, bool commit)
 {
     if (!data)
         return;
 
-    getEnv()->ReleaseByteArrayElements(reinterpret_cast<jbyteArray>(arrayObject), data, 0);
+    getEnv()->ReleaseByteArrayElements(reinterpret_cast<jbyteArray>(arrayObject), data, commit ? 0 : JNI_ABORT);
+}
+
+void getByteArrayRegion(ref_t arrayObject, size_t start, size_t count, int8_t* data)
+{
+    getEnv()->GetByteArrayRegion(reinterpret_cast<jbyteArray>(arrayObject), start, count, data);
+}
+
+void setByteArrayRegion(ref_t arrayObject, size_t start, size_t count, const int8_t* data)
+{
+    getEnv()->SetByteArrayRegion(reinterpret_cast<jbyteArray>(arrayObject), start, count, data);
 }
 
 ref_t newFloatArrayObject(const float* data, size_t count)
@@ -131,11 +164,8 @@ ref_t newFloatArrayObject(const float* data, size_t count)
     if (!arrayObject)
         return 0;
 
-    jfloat* arrayElements = getEnv()->GetFloatArrayElements(arrayObject, NULL);
-    if (arrayElements) {
-        memcpy(arrayElements, data, sizeof(jfloat) * count);
-        getEnv()->ReleaseFloatArrayElements(arrayObject, arrayElements, 0);
-    }
+    if (count)
+        getEnv()->SetFloatArrayRegion(arrayObject, 0, count, data);
 
     return arrayObject;
 }
@@ -145,12 +175,22 @@ float* getFloatArrayElements(ref_t arrayObject)
     return getEnv()->GetFloatArrayElements(reinterpret_cast<jfloatArray>(arrayObject), NULL);
 }
 
-void releaseFloatArrayElements(ref_t arrayObject, float* data, size_t)
+void releaseFloatArrayElements(ref_t arrayObject, float* data, size_t, bool commit)
 {
     if (!data)
         return;
 
-    getEnv()->ReleaseFloatArrayElements(reinterpret_cast<jfloatArray>(arrayObject), data, 0);
+    getEnv()->ReleaseFloatArrayElements(reinterpret_cast<jfloatArray>(arrayObject), data, commit ? 0 : JNI_ABORT);
+}
+
+void getFloatArrayRegion(ref_t arrayObject, size_t start, size_t count, float* data)
+{
+    getEnv()->GetFloatArrayRegion(reinterpret_cast<jfloatArray>(arrayObject), start, count, data);
+}
+
+void setFloatArrayRegion(ref_t arrayObject, size_t start, size_t count, const float* data)
+{
+    getEnv()->SetFloatArrayRegion(reinterpret_cast<jfloatArray>(arrayObject), start, count, data);
 }
 
 ref_t newDoubleArrayObject(const double* data, size_t count)
@@ -159,11 +199,8 @@ ref_t newDoubleArrayObject(const double* data, size_t count)
     if (!arrayObject)
         return 0;
 
-    jdouble* arrayElements = getEnv()->GetDoubleArrayElements(arrayObject, NULL);
-    if (arrayElements) {
-        memcpy(arrayElements, data, sizeof(jdouble) * count);
-        getEnv()->ReleaseDoubleArrayElements(arrayObject, arrayElements, 0);
-    }
+    if (count)
+        getEnv()->SetDoubleArrayRegion(arrayObject, 0, count, data);
 
     return arrayObject;
 }
@@ -173,12 +210,136 @@ double* getDoubleArrayElements(ref_t arrayObject)
     return getEnv()->GetDoubleArrayElements(reinterpret_cast<jdoubleArray>(arrayObject), NULL);
 }
 
-void releaseDoubleArrayElements(ref_t arrayObject, double* data, size_t)
+void releaseDoubleArrayElements(ref_t arrayObject, double* data, size_t, bool commit)
+{
+    if (!data)
+        return;
+
+    getEnv()->ReleaseDoubleArrayElements(reinterpret_cast<jdoubleArray>(arrayObject), data, commit ? 0 : JNI_ABORT);
+}
+
+void getDoubleArrayRegion(ref_t arrayObject, size_t start, size_t count, double* data)
+{
+    getEnv()->GetDoubleArrayRegion(reinterpret_cast<jdoubleArray>(arrayObject), start, count, data);
+}
+
+void setDoubleArrayRegion(ref_t arrayObject, size_t start, size_t count, const double* data)
+{
+    getEnv()->SetDoubleArrayRegion(reinterpret_cast<jdoubleArray>(arrayObject), start, count, data);
+}
+
+ref_t newLongArrayObject(const int64_t* data, size_t count)
+{
+    jlongArray arrayObject = getEnv()->NewLongArray(count);
+    if (!arrayObject)
+        return 0;
+
+    if (count)
+        getEnv()->SetLongArrayRegion(arrayObject, 0, count, data);
+
+    return arrayObject;
+}
+
+int64_t* getLongArrayElements(ref_t arrayObject)
+{
+    return getEnv()->GetLongArrayElements(reinterpret_cast<jlongArray>(arrayObject), NULL);
+}
+
+void releaseLongArrayElements(ref_t arrayObject, int64_t* data, size_t, bool commit)
 {
     if (!data)
         return;
 
-    getEnv()->ReleaseDoubleArrayElements(reinterpret_cast<jdoubleArray>(arrayObject), data, 0);
+    getEnv()->ReleaseLongArrayElements(reinterpret_cast<jlongArray>(arrayObject), data, commit ? 0 : JNI_ABORT);
+}
+
+void getLongArrayRegion(ref_t arrayObject, size_t start, size_t count, int64_t* data)
+{
+    getEnv()->GetLongArrayRegion(reinterpret_cast<jlongArray>(arrayObject), start, count, data);
+}
+
+void setLongArrayRegion(ref_t arrayObject, size_t start, size_t count, const int64_t* data)
+{
+    getEnv()->SetLongArrayRegion(reinterpret_cast<jlongArray>(arrayObject), start, count, data);
+}
+
+ref_t newCharArrayObject(const uint16_t* data, size_t count)
+{
+    jcharArray arrayObject = getEnv()->NewCharArray(count);
+    if (!arrayObject)
+        return 0;
+
+    if (count)
+        getEnv()->SetCharArrayRegion(arrayObject, 0, count, data);
+
+    return arrayObject;
+}
+
+uint16_t* getCharArrayElements(ref_t arrayObject)
+{
+    return getEnv()->GetCharArrayElements(reinterpret_cast<jcharArray>(arrayObject), NULL);
+}
+
+void releaseCharArrayElements(ref_t arrayObject, uint16_t* data, size_t, bool commit)
+{
+    if (!data)
+        return;
+
+    getEnv()->ReleaseCharArrayElements(reinterpret_cast<jcharArray>(arrayObject), data, commit ? 0 : JNI_ABORT);
+}
+
+void getCharArrayRegion(ref_t arrayObject, size_t start, size_t count, uint16_t* data)
+{
+    getEnv()->GetCharArrayRegion(reinterpret_cast<jcharArray>(arrayObject), start, count, data);
+}
+
+void setCharArrayRegion(ref_t arrayObject, size_t start, size_t count, const uint16_t* data)
+{
+    getEnv()->SetCharArrayRegion(reinterpret_cast<jcharArray>(arrayObject), start, count, data);
+}
+
+static_assert(sizeof(bool) == sizeof(jboolean), "bool arrays are copied as jboolean arrays");
+
+ref_t newBooleanArrayObject(const bool* data, size_t count)
+{
+    jbooleanArray arrayObject = getEnv()->NewBooleanArray(count);
+    if (!arrayObject)
+        return 0;
+
+    if (count)
+        getEnv()->SetBooleanArrayRegion(arrayObject, 0, count, reinterpret_cast<const jboolean*>(data));
+
+    return arrayObject;
+}
+
+ref_t newBooleanArrayObject(const std::vector<bool>& data)
+{
+    // std::vector<bool> is bit-packed, so its values are widened into a jboolean buffer first.
+    std::vector<jboolean> buffer(data.begin(), data.end());
+    return newBooleanArrayObject(reinterpret_cast<const bool*>(buffer.data()), buffer.size());
+}
+
+bool* getBooleanArrayElements(ref_t arrayObject)
+{
+    return reinterpret_cast<bool*>(getEnv()->GetBooleanArrayElements(reinterpret_cast<jbooleanArray>(arrayObject), NULL));
+}
+
+void releaseBooleanArrayElements(ref_t arrayObject, bool* data, size_t, bool commit)
+{
+    if (!data)
+        return;
+
+    getEnv()->ReleaseBooleanArrayElements(reinterpret_cast<jbooleanArray>(arrayObject), reinterpret_cast<jboolean*>(data), commit ? 0 : JNI_ABORT);
+}
+
+void getBooleanArrayRegion(ref_t arrayObject, size_t start, size_t count, bool* data)
+{
+    getEnv()->GetBooleanArrayRegion(reinterpret_cast<jbooleanArray>(arrayObject), start, count, reinterpret_cast<jboolean*>(data));
+}
+
+void setBooleanArrayRegion(ref_t arrayObject, size_t start, size_t count, const bool* data)
+{
+    getEnv()->SetBooleanArrayRegion(reinterpret_cast<jbooleanArray>(arrayObject), start, count, reinterpret_cast<const jboolean*>(data));
 }
 
 static jclass ClassID_java_lang_String()
@@ -189,12 +350,32 @@ static jclass ClassID_java_lang_String()
 
 ref_t newStringArrayObject(const std::string* data, size_t count)
 {
-    jobjectArray arrayObject = getEnv()->NewStringArray(count, ClassID_java_lang_String(), NULL);
+    JNIEnv* env = getEnv();
+    jobjectArray arrayObject = env->NewStringArray(count, ClassID_java_lang_String(), NULL);
     if (!arrayObject)
         return 0;
 
-    for (size_t index = 0; index < count; ++index)
-        getEnv()->SetStringArrayElement(arrayObject, index, getEnv()->NewStringUTF(data[index].data()));
+    std::vector<jchar> buffer;
+
+    for (size_t chunk = 0; chunk < count; chunk += localFrameChunkSize) {
+        LocalFrame frame(localFrameChunkSize, env);
+        size_t chunkEnd = std::min(count, chunk + localFrameChunkSize);
+        for (size_t index = chunk; index < chunkEnd; ++index) {
+            if (buffer.size() < data[index].size())
+                buffer.resize(data[index].size());
+            size_t length = utf8ToUTF16(data[index].data(), data[index].size(), buffer.data());
+            jstring element = env->NewString(buffer.data(), length);
+            if (!element) {
+                ALOGE("NewString failed for element %zu", index);
+                // arrayObject belongs to the enclosing frame, which is the only one it can be deleted from.
+                frame.pop(nullptr);
+                env->DeleteLocalRef(arrayObject);
+                return 0;
+            }
+            env->SetStringArrayElement(arrayObject, index, element);
+            env->DeleteLocalRef(element);
+        }
+    }
 
     return arrayObject;
 }
@@ -205,23 +386,33 @@ std::string* getStringArrayElements(ref_t arrayObject)
     if (count < 1)
         return nullptr;
 
+    JNIEnv* env = getEnv();
     std::string* strings = new std::string[count];
-
-    for (size_t index = 0; index < count; ++index) {
-        jstring element = (jstring)getEnv()->GetStringArrayElement(reinterpret_cast<jobjectArray>(arrayObject), index);
-
-        const char* chars = getEnv()->GetStringUTFChars(element, NULL);
-        if (chars) {
-            jsize length = getEnv()->GetStringUTFLength(element);
-            strings[index].assign(chars, length);
-            getEnv()->ReleaseStringUTFChars(element, chars);
+    // Every element is copied into this buffer, which only grows, instead of
+    // pinning its characters.
+    std::vector<jchar> buffer;
+
+    for (size_t chunk = 0; chunk < count; chunk += localFrameChunkSize) {
+        LocalFrame frame(localFrameChunkSize, env);
+        size_t chunkEnd = std::min(count, chunk + localFrameChunkSize);
+        for (size_t index = chunk; index < chunkEnd; ++index) {
+            jstring element = (jstring)env->GetStringArrayElement(reinterpret_cast<jobjectArray>(arrayObject), index);
+            if (!element)
+                continue;
+
+            size_t length = env->GetStringLength(element);
+            if (buffer.size() < length)
+                buffer.resize(length);
+            env->GetStringRegion(element, 0, length, buffer.data());
+            strings[index] = utf16ToUTF8(buffer.data(), length);
+            env->DeleteLocalRef(element);
         }
     }
 
     return strings;
 }
 
-void releaseStringArrayElements(ref_t arrayObject, std::string* data, size_t)
+void releaseStringArrayElements(ref_t arrayObject, std::string* data, size_t, bool)
 {
     if (!data)
         return;
@@ -253,6 +444,11 @@ std::vector<ref_t> getObjectArrayElementsData(ref_t arrayObject)
     if (count < 1)
         return std::vector<ref_t>();
 
+    // The elements outlive this call as local references, so reserve room for all of them up front.
+    // On failure an OutOfMemoryError is pending and the caller sees no elements at all.
+    if (!LocalFrame::ensureCapacity(count))
+        return std::vector<ref_t>();
+
     std::vector<ref_t> objects(count, nullptr);
 
     for (size_t index = 0; index < count; ++index)
@@ -261,7 +457,7 @@ std::vector<ref_t> getObjectArrayElementsData(ref_t arrayObject)
     return objects;
 }
 
-void releaseObjectArrayElements(ref_t arrayObject, PassLocalRef<AnyObject>* data, size_t count)
+void releaseObjectArrayElements(ref_t arrayObject, PassLocalRef<AnyObject>* data, size_t count, bool)
 {
     if (!data)
         return;
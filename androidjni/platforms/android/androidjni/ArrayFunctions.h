@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "ObjectArrayView.h"
 #include <androidjni/PassLocalRef.h>
 
 #include <vector>
@@ -39,79 +40,148 @@ class ArrayFunctions {
 public:
     static ref_t newArrayObject(const T* data, size_t count);
     static T* getArrayObjectElements(ref_t arrayObject);
-    static void releaseArrayObjectElements(ref_t arrayObject, T* data, size_t count);
+    // Elements obtained for reading only are released with commit set to false.
+    static void releaseArrayObjectElements(ref_t arrayObject, T* data, size_t count, bool commit);
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, T* data);
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const T* data);
 };
 
 ref_t newIntArrayObject(const int32_t* data, size_t count);
 int32_t* getIntArrayElements(ref_t arrayObject);
-void releaseIntArrayElements(ref_t arrayObject, int32_t*, size_t count);
+void releaseIntArrayElements(ref_t arrayObject, int32_t*, size_t count, bool commit);
+void getIntArrayRegion(ref_t arrayObject, size_t start, size_t count, int32_t* data);
+void setIntArrayRegion(ref_t arrayObject, size_t start, size_t count, const int32_t* data);
 
 template<> class ArrayFunctions<int32_t> {
 public:
     static ref_t newArrayObject(const int32_t* data, size_t count) { return newIntArrayObject(data, count); }
     static int32_t* getArrayObjectElements(ref_t arrayObject) { return getIntArrayElements(arrayObject); }
-    static void releaseArrayObjectElements(ref_t arrayObject, int32_t* data, size_t count) { return releaseIntArrayElements(arrayObject, data, count); }
+    static void releaseArrayObjectElements(ref_t arrayObject, int32_t* data, size_t count, bool commit) { return releaseIntArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, int32_t* data) { getIntArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const int32_t* data) { setIntArrayRegion(arrayObject, start, count, data); }
 };
 
 ref_t newShortArrayObject(const int16_t* data, size_t count);
 int16_t* getShortArrayElements(ref_t arrayObject);
-void releaseShortArrayElements(ref_t arrayObject, int16_t*, size_t count);
+void releaseShortArrayElements(ref_t arrayObject, int16_t*, size_t count, bool commit);
+void getShortArrayRegion(ref_t arrayObject, size_t start, size_t count, int16_t* data);
+void setShortArrayRegion(ref_t arrayObject, size_t start, size_t count, const int16_t* data);
 
 template<> class ArrayFunctions<int16_t> {
 public:
     static ref_t newArrayObject(const int16_t* data, size_t count) { return newShortArrayObject(data, count); }
     static int16_t* getArrayObjectElements(ref_t arrayObject) { return getShortArrayElements(arrayObject); }
-    static void releaseArrayObjectElements(ref_t arrayObject, int16_t* data, size_t count) { return releaseShortArrayElements(arrayObject, data, count); }
+    static void releaseArrayObjectElements(ref_t arrayObject, int16_t* data, size_t count, bool commit) { return releaseShortArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, int16_t* data) { getShortArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const int16_t* data) { setShortArrayRegion(arrayObject, start, count, data); }
 };
 
 ref_t newByteArrayObject(const int8_t* data, size_t count);
 int8_t* getByteArrayElements(ref_t arrayObject);
-void releaseByteArrayElements(ref_t arrayObject, int8_t*, size_t count);
+void releaseByteArrayElements(ref_t arrayObject, int8_t*, size_t count, bool commit);
+void getByteArrayRegion(ref_t arrayObject, size_t start, size_t count, int8_t* data);
+void setByteArrayRegion(ref_t arrayObject, size_t start, size_t count, const int8_t* data);
 
 template<> class ArrayFunctions<int8_t> {
 public:
     static ref_t newArrayObject(const int8_t* data, size_t count) { return newByteArrayObject(data, count); }
     static int8_t* getArrayObjectElements(ref_t arrayObject) { return getByteArrayElements(arrayObject); }
-    static void releaseArrayObjectElements(ref_t arrayObject, int8_t* data, size_t count) { return releaseByteArrayElements(arrayObject, data, count); }
+    static void releaseArrayObjectElements(ref_t arrayObject, int8_t* data, size_t count, bool commit) { return releaseByteArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, int8_t* data) { getByteArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const int8_t* data) { setByteArrayRegion(arrayObject, start, count, data); }
 };
 
 ref_t newFloatArrayObject(const float* data, size_t count);
 float* getFloatArrayElements(ref_t arrayObject);
-void releaseFloatArrayElements(ref_t arrayObject, float*, size_t count);
+void releaseFloatArrayElements(ref_t arrayObject, float*, size_t count, bool commit);
+void getFloatArrayRegion(ref_t arrayObject, size_t start, size_t count, float* data);
+void setFloatArrayRegion(ref_t arrayObject, size_t start, size_t count, const float* data);
 
 template<> class ArrayFunctions<float> {
 public:
     static ref_t newArrayObject(const float* data, size_t count) { return newFloatArrayObject(data, count); }
     static float* getArrayObjectElements(ref_t arrayObject) { return getFloatArrayElements(arrayObject); }
-    static void releaseArrayObjectElements(ref_t arrayObject, float* data, size_t count) { return releaseFloatArrayElements(arrayObject, data, count); }
+    static void releaseArrayObjectElements(ref_t arrayObject, float* data, size_t count, bool commit) { return releaseFloatArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, float* data) { getFloatArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const float* data) { setFloatArrayRegion(arrayObject, start, count, data); }
 };
 
 ref_t newDoubleArrayObject(const double* data, size_t count);
 double* getDoubleArrayElements(ref_t arrayObject);
-void releaseDoubleArrayElements(ref_t arrayObject, double*, size_t count);
+void releaseDoubleArrayElements(ref_t arrayObject, double*, size_t count, bool commit);
+void getDoubleArrayRegion(ref_t arrayObject, size_t start, size_t count, double* data);
+void setDoubleArrayRegion(ref_t arrayObject, size_t start, size_t count, const double* data);
 
 template<> class ArrayFunctions<double> {
 public:
     static ref_t newArrayObject(const double* data, size_t count) { return newDoubleArrayObject(data, count); }
     static double* getArrayObjectElements(ref_t arrayObject) { return getDoubleArrayElements(arrayObject); }
-    static void releaseArrayObjectElements(ref_t arrayObject, double* data, size_t count) { return releaseDoubleArrayElements(arrayObject, data, count); }
+    static void releaseArrayObjectElements(ref_t arrayObject, double* data, size_t count, bool commit) { return releaseDoubleArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, double* data) { getDoubleArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const double* data) { setDoubleArrayRegion(arrayObject, start, count, data); }
+};
+
+ref_t newLongArrayObject(const int64_t* data, size_t count);
+int64_t* getLongArrayElements(ref_t arrayObject);
+void releaseLongArrayElements(ref_t arrayObject, int64_t*, size_t count, bool commit);
+void getLongArrayRegion(ref_t arrayObject, size_t start, size_t count, int64_t* data);
+void setLongArrayRegion(ref_t arrayObject, size_t start, size_t count, const int64_t* data);
+
+template<> class ArrayFunctions<int64_t> {
+public:
+    static ref_t newArrayObject(const int64_t* data, size_t count) { return newLongArrayObject(data, count); }
+    static int64_t* getArrayObjectElements(ref_t arrayObject) { return getLongArrayElements(arrayObject); }
+    static void releaseArrayObjectElements(ref_t arrayObject, int64_t* data, size_t count, bool commit) { return releaseLongArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, int64_t* data) { getLongArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const int64_t* data) { setLongArrayRegion(arrayObject, start, count, data); }
+};
+
+ref_t newCharArrayObject(const uint16_t* data, size_t count);
+uint16_t* getCharArrayElements(ref_t arrayObject);
+void releaseCharArrayElements(ref_t arrayObject, uint16_t*, size_t count, bool commit);
+void getCharArrayRegion(ref_t arrayObject, size_t start, size_t count, uint16_t* data);
+void setCharArrayRegion(ref_t arrayObject, size_t start, size_t count, const uint16_t* data);
+
+template<> class ArrayFunctions<uint16_t> {
+public:
+    static ref_t newArrayObject(const uint16_t* data, size_t count) { return newCharArrayObject(data, count); }
+    static uint16_t* getArrayObjectElements(ref_t arrayObject) { return getCharArrayElements(arrayObject); }
+    static void releaseArrayObjectElements(ref_t arrayObject, uint16_t* data, size_t count, bool commit) { return releaseCharArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, uint16_t* data) { getCharArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const uint16_t* data) { setCharArrayRegion(arrayObject, start, count, data); }
+};
+
+ref_t newBooleanArrayObject(const bool* data, size_t count);
+ref_t newBooleanArrayObject(const std::vector<bool>& data);
+bool* getBooleanArrayElements(ref_t arrayObject);
+void releaseBooleanArrayElements(ref_t arrayObject, bool*, size_t count, bool commit);
+void getBooleanArrayRegion(ref_t arrayObject, size_t start, size_t count, bool* data);
+void setBooleanArrayRegion(ref_t arrayObject, size_t start, size_t count, const bool* data);
+
+template<> class ArrayFunctions<bool> {
+public:
+    static ref_t newArrayObject(const bool* data, size_t count) { return newBooleanArrayObject(data, count); }
+    static bool* getArrayObjectElements(ref_t arrayObject) { return getBooleanArrayElements(arrayObject); }
+    static void releaseArrayObjectElements(ref_t arrayObject, bool* data, size_t count, bool commit) { return releaseBooleanArrayElements(arrayObject, data, count, commit); }
+    static void getArrayRegion(ref_t arrayObject, size_t start, size_t count, bool* data) { getBooleanArrayRegion(arrayObject, start, count, data); }
+    static void setArrayRegion(ref_t arrayObject, size_t start, size_t count, const bool* data) { setBooleanArrayRegion(arrayObject, start, count, data); }
 };
 
 ref_t newStringArrayObject(const std::string* data, size_t count);
 std::string* getStringArrayElements(ref_t arrayObject);
-void releaseStringArrayElements(ref_t arrayObject, std::string*, size_t count);
+void releaseStringArrayElements(ref_t arrayObject, std::string*, size_t count, bool commit);
 
 template<> class ArrayFunctions<std::string> {
 public:
     static ref_t newArrayObject(const std::string* data, size_t count) { return newStringArrayObject(data, count); }
     static std::string* getArrayObjectElements(ref_t arrayObject) { return getStringArrayElements(arrayObject); }
-    static void releaseArrayObjectElements(ref_t arrayObject, std::string* data, size_t count) { return releaseStringArrayElements(arrayObject, data, count); }
+    static void releaseArrayObjectElements(ref_t arrayObject, std::string* data, size_t count, bool commit) { return releaseStringArrayElements(arrayObject, data, count, commit); }
 };
 
 ref_t newObjectArrayObject(const PassLocalRef<AnyObject>* data, size_t count);
 std::vector<ref_t> getObjectArrayElementsData(ref_t arrayObject);
 template<typename T> PassLocalRef<T>* getObjectArrayElements(std::vector<ref_t>&& elementsData);
-void releaseObjectArrayElements(ref_t arrayObject, PassLocalRef<AnyObject>*, size_t count);
+void releaseObjectArrayElements(ref_t arrayObject, PassLocalRef<AnyObject>*, size_t count, bool commit);
 
 template<typename T> PassLocalRef<T>* getObjectArrayElements(std::vector<ref_t>&& elementsData)
 {
@@ -120,8 +190,8 @@ template<typename T> PassLocalRef<T>* getObjectArrayElements(std::vector<ref_t>&
 
     PassLocalRef<T>* objects = reinterpret_cast<PassLocalRef<T>*>(malloc(sizeof(PassLocalRef<T>) * elementsData.size()));
 
-    for (ref_t elementData : elementsData)
-        new (objects + index) PassLocalRef<T>(T::fromRef(elementData));
+    for (size_t index = 0; index < elementsData.size(); ++index)
+        new (objects + index) PassLocalRef<T>(adoptObjectArrayElement<T>(elementsData[index]));
 
     return objects;
 }
@@ -130,7 +200,7 @@ template<typename T> class ArrayFunctions<PassLocalRef<T>> {
 public:
     static ref_t newArrayObject(const PassLocalRef<T>* data, size_t count) { return newObjectArrayObject(reinterpret_cast<const PassLocalRef<AnyObject>*>(data), count); }
     static PassLocalRef<T>* getArrayObjectElements(ref_t arrayObject) { return getObjectArrayElements<T>(getObjectArrayElementsData(arrayObject)); }
-    static void releaseArrayObjectElements(ref_t arrayObject, PassLocalRef<T>* data, size_t count) { return releaseObjectArrayElements(arrayObject, reinterpret_cast<PassLocalRef<AnyObject>*>(data), count); }
+    static void releaseArrayObjectElements(ref_t arrayObject, PassLocalRef<T>* data, size_t count, bool commit) { return releaseObjectArrayElements(arrayObject, reinterpret_cast<PassLocalRef<AnyObject>*>(data), count, commit); }
 };
 
 } // namespace JNI
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "PassArray.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+namespace JNI {
+
+// Number of bytes copied per Get/Set<Type>ArrayRegion call by the array streams.
+static const size_t arrayStreamWindowBytes = 64 * 1024;
+
+// Reads a slice of a primitive array window by window through a reused native
+// buffer. Only one window is held at a time and the array is never pinned.
+// Reads go to the array object, so changes made through mutableData() are seen
+// only once the PassArray has released its elements.
+// The buffers are plain arrays rather than std::vector so that bool streams get
+// one byte per element, matching jboolean.
+template<typename T>
+class ArrayStreamReader final {
+public:
+    class Window {
+    public:
+        const T* data() const { return m_data; }
+        size_t count() const { return m_count; }
+        size_t offset() const { return m_offset; } // Relative to the start of the slice.
+
+        const T* begin() const { return m_data; }
+        const T* end() const { return m_data + m_count; }
+
+    private:
+        friend class ArrayStreamReader;
+        const T* m_data;
+        size_t m_count;
+        size_t m_offset;
+    };
+
+    class iterator {
+    public:
+        const Window& operator*() const { return m_reader->m_window; }
+        const Window* operator->() const { return &m_reader->m_window; }
+        iterator& operator++()
+        {
+            if (!m_reader->next())
+                m_reader = nullptr;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return m_reader == other.m_reader; }
+        bool operator!=(const iterator& other) const { return m_reader != other.m_reader; }
+
+    private:
+        friend class ArrayStreamReader;
+        explicit iterator(ArrayStreamReader* reader) : m_reader(reader) { }
+        ArrayStreamReader* m_reader;
+    };
+
+    explicit ArrayStreamReader(const PassArray<T>& array, size_t offset = 0, size_t length = SIZE_MAX, size_t windowSize = arrayStreamWindowBytes / sizeof(T))
+        : m_array(array.get())
+        , m_position(0)
+    {
+        size_t arrayLength = m_array ? getArrayObjectElementsCount(m_array) : 0;
+        m_start = std::min(offset, arrayLength);
+        m_length = std::min(length, arrayLength - m_start);
+        m_capacity = std::max<size_t>(1, std::min(windowSize, m_length));
+        m_buffer.reset(new T[m_capacity]);
+        m_window.m_data = m_buffer.get();
+        m_window.m_count = 0;
+        m_window.m_offset = 0;
+    }
+    // The stream reads through the array's reference, which a temporary would release.
+    ArrayStreamReader(const PassArray<T>&&, size_t = 0, size_t = SIZE_MAX, size_t = 0) = delete;
+
+    size_t length() const { return m_length; }
+    size_t position() const { return m_position; }
+
+    // Copies the next window of the slice into the buffer. Returns false at the end.
+    bool next()
+    {
+        size_t count = std::min(m_capacity, m_length - m_position);
+        m_window.m_offset = m_position;
+        m_window.m_count = count;
+        if (!count)
+            return false;
+
+        ArrayFunctions<T>::getArrayRegion(m_array, m_start + m_position, count, m_buffer.get());
+        m_position += count;
+        return true;
+    }
+    const Window& window() const { return m_window; }
+
+    // Iterating restarts from the beginning of the slice.
+    iterator begin()
+    {
+        m_position = 0;
+        return next() ? iterator(this) : end();
+    }
+    iterator end() { return iterator(nullptr); }
+
+private:
+    ArrayStreamReader(const ArrayStreamReader&) = delete;
+    ArrayStreamReader& operator=(const ArrayStreamReader&) = delete;
+
+    ref_t m_array;
+    size_t m_start;
+    size_t m_length;
+    size_t m_position;
+    size_t m_capacity;
+    std::unique_ptr<T[]> m_buffer;
+    Window m_window;
+}; // class ArrayStreamReader
+
+// Writes a slice of a primitive array sequentially. Small writes are gathered in a
+// reused native buffer and flushed a window at a time through
+// PassArray::setRegion(), so they also land in elements the array already
+// fetched with mutableData() rather than being overwritten when those are
+// released. Writes past the end of the slice are dropped.
+template<typename T>
+class ArrayStreamWriter final {
+public:
+    explicit ArrayStreamWriter(PassArray<T>& array, size_t offset = 0, size_t length = SIZE_MAX, size_t windowSize = arrayStreamWindowBytes / sizeof(T))
+        : m_array(array)
+        , m_position(0)
+        , m_buffered(0)
+    {
+        size_t arrayLength = array.get() ? getArrayObjectElementsCount(array.get()) : 0;
+        m_start = std::min(offset, arrayLength);
+        m_length = std::min(length, arrayLength - m_start);
+        m_capacity = std::max<size_t>(1, std::min(windowSize, m_length));
+        m_buffer.reset(new T[m_capacity]);
+    }
+    ~ArrayStreamWriter()
+    {
+        flush();
+    }
+
+    size_t length() const { return m_length; }
+    size_t position() const { return m_position + m_buffered; }
+
+    // Returns the number of elements accepted.
+    size_t write(const T* data, size_t count)
+    {
+        count = std::min(count, m_length - position());
+        if (m_buffered + count <= m_capacity) {
+            std::copy(data, data + count, m_buffer.get() + m_buffered);
+            m_buffered += count;
+            if (m_buffered == m_capacity)
+                flush();
+            return count;
+        }
+
+        // Larger writes go straight from the caller's memory.
+        flush();
+        m_array.setRegion(m_start + m_position, data, count);
+        m_position += count;
+        return count;
+    }
+    bool put(T value) { return write(&value, 1) == 1; }
+
+    void flush()
+    {
+        if (!m_buffered)
+            return;
+
+        m_array.setRegion(m_start + m_position, m_buffer.get(), m_buffered);
+        m_position += m_buffered;
+        m_buffered = 0;
+    }
+
+private:
+    ArrayStreamWriter(const ArrayStreamWriter&) = delete;
+    ArrayStreamWriter& operator=(const ArrayStreamWriter&) = delete;
+
+    PassArray<T>& m_array;
+    size_t m_start;
+    size_t m_length;
+    size_t m_position;
+    size_t m_capacity;
+    size_t m_buffered;
+    std::unique_ptr<T[]> m_buffer;
+}; // class ArrayStreamWriter
+
+} // namespace JNI
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JavaVM.h"
+#include <androidjni/ReferenceFunctions.h>
+
+#include <type_traits>
+
+namespace JNI {
+
+// Accesses the elements of a primitive array in place through GetPrimitiveArrayCritical.
+// The VM may suspend garbage collection while the view is alive, so keep it short
+// and do not call back into JNI or block until it is destroyed.
+template<typename T>
+class CriticalArrayView final {
+    static_assert(std::is_arithmetic<T>::value, "CriticalArrayView requires a primitive element type");
+public:
+    explicit CriticalArrayView(ref_t array, JNIEnv* env = getEnv())
+        : m_env(env)
+        , m_array(reinterpret_cast<jarray>(array))
+        , m_count(array ? env->GetArrayLength(m_array) : 0)
+        , m_data(array ? static_cast<T*>(env->GetPrimitiveArrayCritical(m_array, NULL)) : nullptr)
+    {
+        if (array && !m_data)
+            ALOGE("GetPrimitiveArrayCritical failed");
+    }
+    ~CriticalArrayView()
+    {
+        if (m_data)
+            m_env->ReleasePrimitiveArrayCritical(m_array, m_data, 0);
+    }
+
+    T* data() const { return m_data; }
+    size_t count() const { return m_data ? m_count : 0; }
+
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + count(); }
+    T& operator[](size_t index) const { return m_data[index]; }
+
+private:
+    CriticalArrayView(const CriticalArrayView&) = delete;
+    CriticalArrayView& operator=(const CriticalArrayView&) = delete;
+
+    JNIEnv* m_env;
+    jarray m_array;
+    size_t m_count;
+    T* m_data;
+};
+
+}
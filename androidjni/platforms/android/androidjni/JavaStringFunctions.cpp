@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "androidjni/JavaStringFunctions.h"
+
+#include <algorithm>
+
+namespace JNI {
+
+// Up to this many code units are copied to the stack instead of being pinned.
+static const size_t stackCharsLength = 256;
+
+// Calls function(chars, length) on at most maxLength leading code units of string.
+template<typename Result, typename Function>
+static Result withStringChars(JNIEnv* env, jstring string, size_t maxLength, Result failure, Function function)
+{
+    size_t length = std::min<size_t>(env->GetStringLength(string), maxLength);
+    if (length <= stackCharsLength) {
+        jchar chars[stackCharsLength];
+        env->GetStringRegion(string, 0, length, chars);
+        return function(chars, length);
+    }
+
+    const jchar* chars = env->GetStringCritical(string, NULL);
+    if (!chars)
+        return failure;
+
+    Result result = function(chars, length);
+    env->ReleaseStringCritical(string, chars);
+    return result;
+}
+
+int32_t stringHashCode(jstring string, JNIEnv* env)
+{
+    if (!string)
+        return 0;
+
+    return withStringChars(env, string, SIZE_MAX, 0, [](const uint16_t* chars, size_t length) {
+        return javaHashCode(chars, length);
+    });
+}
+
+bool stringEquals(jstring string, const char* other, size_t length, JNIEnv* env)
+{
+    if (!string)
+        return false;
+
+    // Every code unit takes one to three bytes of UTF-8.
+    size_t stringLength = env->GetStringLength(string);
+    if (stringLength > length || stringLength * 3 < length)
+        return false;
+
+    return withStringChars(env, string, stringLength, false, [&](const uint16_t* chars, size_t charsLength) {
+        return equalsUTF8(chars, charsLength, other, length);
+    });
+}
+
+bool stringStartsWith(jstring string, const char* prefix, size_t length, JNIEnv* env)
+{
+    if (!string)
+        return false;
+
+    // The prefix is at most as many code units as it has bytes.
+    return withStringChars(env, string, length, false, [&](const uint16_t* chars, size_t charsLength) {
+        return startsWithUTF8(chars, charsLength, prefix, length);
+    });
+}
+
+ptrdiff_t stringIndexOf(jstring string, uint16_t c, size_t from, JNIEnv* env)
+{
+    if (!string)
+        return -1;
+
+    return withStringChars(env, string, SIZE_MAX, ptrdiff_t(-1), [&](const uint16_t* chars, size_t length) {
+        return indexOf(chars, length, c, from);
+    });
+}
+
+ptrdiff_t stringIndexOf(jstring string, const uint16_t* needle, size_t needleLength, size_t from, JNIEnv* env)
+{
+    if (!string)
+        return -1;
+
+    return withStringChars(env, string, SIZE_MAX, ptrdiff_t(-1), [&](const uint16_t* chars, size_t length) {
+        return indexOf(chars, length, needle, needleLength, from);
+    });
+}
+
+} // namespace JNI
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JavaVM.h"
+#include <androidjni/UTF16Functions.h>
+
+#include <cstring>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace JNI {
+
+// Lookups on Java strings that read the characters in place instead of converting
+// the string with toNative(). Short strings are copied to the stack with
+// GetStringRegion and longer ones are pinned with GetStringCritical, so nothing is
+// allocated. UTF-8 arguments are compared with the UTF-16 form they decode to.
+// A null string has hash code 0, equals and starts with nothing, and contains nothing.
+
+JNI_EXPORT int32_t stringHashCode(jstring, JNIEnv* env = getEnv());
+
+JNI_EXPORT bool stringEquals(jstring, const char* string, size_t length, JNIEnv* env = getEnv());
+JNI_EXPORT bool stringStartsWith(jstring, const char* prefix, size_t length, JNIEnv* env = getEnv());
+
+JNI_EXPORT ptrdiff_t stringIndexOf(jstring, uint16_t c, size_t from = 0, JNIEnv* env = getEnv());
+JNI_EXPORT ptrdiff_t stringIndexOf(jstring, const uint16_t* needle, size_t needleLength, size_t from = 0, JNIEnv* env = getEnv());
+
+inline bool stringEquals(jstring string, const char* other, JNIEnv* env = getEnv())
+{
+    return stringEquals(string, other, strlen(other), env);
+}
+
+inline bool stringEquals(jstring string, const std::string& other, JNIEnv* env = getEnv())
+{
+    return stringEquals(string, other.data(), other.size(), env);
+}
+
+inline bool stringStartsWith(jstring string, const char* prefix, JNIEnv* env = getEnv())
+{
+    return stringStartsWith(string, prefix, strlen(prefix), env);
+}
+
+inline bool stringStartsWith(jstring string, const std::string& prefix, JNIEnv* env = getEnv())
+{
+    return stringStartsWith(string, prefix.data(), prefix.size(), env);
+}
+
+#if __cplusplus >= 201703L
+inline bool stringEquals(jstring string, std::string_view other, JNIEnv* env = getEnv())
+{
+    return stringEquals(string, other.data(), other.size(), env);
+}
+
+inline bool stringStartsWith(jstring string, std::string_view prefix, JNIEnv* env = getEnv())
+{
+    return stringStartsWith(string, prefix.data(), prefix.size(), env);
+}
+
+inline ptrdiff_t stringIndexOf(jstring string, std::u16string_view needle, size_t from = 0, JNIEnv* env = getEnv())
+{
+    return stringIndexOf(string, reinterpret_cast<const uint16_t*>(needle.data()), needle.size(), from, env);
+}
+#endif
+
+} // namespace JNI
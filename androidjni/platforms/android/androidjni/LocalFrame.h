@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JavaVM.h"
+#include <androidjni/ReferenceFunctions.h>
+
+namespace JNI {
+
+// Scopes the local references created inside it with PushLocalFrame/PopLocalFrame,
+// so loops over large arrays do not grow the local reference table.
+class LocalFrame final {
+public:
+    explicit LocalFrame(size_t capacity = 16, JNIEnv* env = getEnv())
+        : m_env(env)
+        , m_pushed(env && env->PushLocalFrame(static_cast<jint>(capacity)) == JNI_OK)
+    {
+        if (env && !m_pushed)
+            ALOGE("PushLocalFrame(%zu) failed", capacity);
+    }
+    ~LocalFrame()
+    {
+        if (m_pushed)
+            m_env->PopLocalFrame(NULL);
+    }
+
+    bool isValid() const { return m_pushed; }
+
+    // Frees every local reference of the frame except result, which is returned
+    // as a new local reference in the enclosing frame.
+    ref_t pop(ref_t result)
+    {
+        if (!m_pushed)
+            return result;
+
+        m_pushed = false;
+        return m_env->PopLocalFrame(reinterpret_cast<jobject>(result));
+    }
+
+    // Makes room for capacity more local references in the current frame.
+    static bool ensureCapacity(size_t capacity, JNIEnv* env = getEnv())
+    {
+        if (env->EnsureLocalCapacity(static_cast<jint>(capacity)) == JNI_OK)
+            return true;
+
+        ALOGE("EnsureLocalCapacity(%zu) failed", capacity);
+        return false;
+    }
+
+private:
+    LocalFrame(const LocalFrame&) = delete;
+    LocalFrame& operator=(const LocalFrame&) = delete;
+
+    JNIEnv* m_env;
+    bool m_pushed;
+};
+
+}
@@ -26,7 +26,13 @@
 #pragma once
 
 #include "PassArray.h"
+#include "ArrayStream.h"
 #include "JavaVM.h"
+#include "LocalFrame.h"
+#include "CriticalArrayView.h"
+#include "JavaStringFunctions.h"
+#include "ObjectArrayView.h"
+#include "StringView.h"
 #include <androidjni/JNIIncludes.h>
 
 namespace JNI {
@@ -34,6 +40,7 @@ namespace JNI {
 ADD_TYPE_MAPPING(jint, int32_t);
 ADD_TYPE_MAPPING(jlong, int64_t);
 ADD_TYPE_MAPPING(jshort, int16_t);
+ADD_TYPE_MAPPING(jchar, uint16_t);
 ADD_TYPE_MAPPING(jbyte, int8_t);
 ADD_TYPE_MAPPING(jfloat, float);
 ADD_TYPE_MAPPING(jdouble, double);
@@ -42,6 +49,18 @@ ADD_TYPE_MAPPING(jboolean, bool);
 jstring toManaged(const std::string&);
 std::string toNative(jstring);
 
+jstring toManaged(JNIEnv*, const std::string&);
+std::string toNative(JNIEnv*, jstring);
+
+jstring toManaged(const InternedString&);
+jstring toManaged(JNIEnv*, const InternedString&);
+
+jbytebuffer toManaged(const DirectBuffer&);
+DirectBuffer toNative(jbytebuffer);
+
+jbytebuffer toManaged(JNIEnv*, const DirectBuffer&);
+DirectBuffer toNative(JNIEnv*, jbytebuffer);
+
 template<typename T, typename U>
 jobject toManaged(const PassLocalRef<U>& ref)
 {
@@ -127,6 +146,36 @@ inline PassArray<double> toNative(jdoubleArray array)
     return PassArray<double>(reinterpret_cast<ref_t>(array));
 }
 
+inline jlongArray toManaged(PassArray<int64_t> arrayObject)
+{
+    return reinterpret_cast<jlongArray>(arrayObject.leak());
+}
+
+inline PassArray<int64_t> toNative(jlongArray array)
+{
+    return PassArray<int64_t>(reinterpret_cast<ref_t>(array));
+}
+
+inline jcharArray toManaged(PassArray<uint16_t> arrayObject)
+{
+    return reinterpret_cast<jcharArray>(arrayObject.leak());
+}
+
+inline PassArray<uint16_t> toNative(jcharArray array)
+{
+    return PassArray<uint16_t>(reinterpret_cast<ref_t>(array));
+}
+
+inline jbooleanArray toManaged(PassArray<bool> arrayObject)
+{
+    return reinterpret_cast<jbooleanArray>(arrayObject.leak());
+}
+
+inline PassArray<bool> toNative(jbooleanArray array)
+{
+    return PassArray<bool>(reinterpret_cast<ref_t>(array));
+}
+
 inline jstringArray toManaged(PassArray<std::string> arrayObject)
 {
     return reinterpret_cast<jstringArray>(arrayObject.leak());
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JavaVM.h"
+#include <androidjni/PassLocalRef.h>
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+namespace JNI {
+
+template<typename T> inline PassLocalRef<T> adoptObjectArrayElement(ref_t element)
+{
+    return element ? T::fromRef(element) : nullptr;
+}
+
+template<> inline PassLocalRef<AnyObject> adoptObjectArrayElement<AnyObject>(ref_t element)
+{
+    return adoptRef(element, reinterpret_cast<AnyObject*>(0));
+}
+
+// Random access to the elements of an Object[] without fetching them up front.
+// An element is fetched only when it is accessed, and the returned PassLocalRef
+// owns its only local reference, so walking an array of any length keeps as many
+// element references alive as the caller holds on to.
+template<typename T>
+class ObjectArrayView final {
+public:
+    class iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef PassLocalRef<T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef PassLocalRef<T> reference;
+
+        PassLocalRef<T> operator*() const { return m_view->at(m_index); }
+        iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator result = *this;
+            ++m_index;
+            return result;
+        }
+        bool operator==(const iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const iterator& other) const { return m_index != other.m_index; }
+
+        size_t index() const { return m_index; }
+
+    private:
+        friend class ObjectArrayView;
+        iterator(const ObjectArrayView* view, size_t index) : m_view(view), m_index(index) { }
+
+        const ObjectArrayView* m_view;
+        size_t m_index;
+    };
+
+    explicit ObjectArrayView(ref_t array, JNIEnv* env = getEnv())
+        : m_array(reinterpret_cast<jobjectArray>(array))
+        , m_env(env)
+        , m_count(array ? env->GetArrayLength(m_array) : 0)
+    {
+    }
+
+    size_t size() const { return m_count; }
+    bool empty() const { return !m_count; }
+
+    PassLocalRef<T> at(size_t index) const
+    {
+        assert(index < m_count);
+        return adoptObjectArrayElement<T>(m_env->GetObjectArrayElement(m_array, index));
+    }
+    PassLocalRef<T> operator[](size_t index) const { return at(index); }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, m_count); }
+
+private:
+    jobjectArray m_array;
+    JNIEnv* m_env;
+    size_t m_count;
+}; // class ObjectArrayView
+
+} // namespace JNI
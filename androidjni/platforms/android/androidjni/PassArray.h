@@ -27,10 +27,17 @@
 
 #include "ArrayFunctions.h"
 
+#include <algorithm>
 #include <array>
 
 namespace JNI {
 
+template<typename T> inline const T* vectorArrayData(const std::vector<T>& vector) { return vector.data(); }
+template<typename T> inline ref_t newVectorArrayObject(const std::vector<T>& vector) { return ArrayFunctions<T>::newArrayObject(vector.data(), vector.size()); }
+// std::vector<bool> has no contiguous storage; data() reads the elements back from the array object.
+inline const bool* vectorArrayData(const std::vector<bool>&) { return nullptr; }
+inline ref_t newVectorArrayObject(const std::vector<bool>& vector) { return newBooleanArrayObject(vector); }
+
 template<typename T>
 class JNI_EXPORT PassArray final {
 public:
@@ -39,6 +46,7 @@ public:
         , m_count(count)
         , m_ref(ArrayFunctions<T>::newArrayObject(m_data, m_count))
         , m_elements(0)
+        , m_modified(false)
     {
     }
     PassArray(const PassArray& array)
@@ -46,6 +54,7 @@ public:
         , m_count(getArrayObjectElementsCount(array.m_ref))
         , m_ref(JNI::refLocal(array.m_ref))
         , m_elements(0)
+        , m_modified(false)
     {
     }
     PassArray(ref_t array)
@@ -53,6 +62,7 @@ public:
         , m_count(getArrayObjectElementsCount(array))
         , m_ref(JNI::refLocal(array))
         , m_elements(0)
+        , m_modified(false)
     {
     }
     template<size_t N> PassArray(const std::array<T, N>& array)
@@ -60,6 +70,7 @@ public:
         , m_count(array.size())
         , m_ref(ArrayFunctions<T>::newArrayObject(m_data, m_count))
         , m_elements(0)
+        , m_modified(false)
     {
     }
     PassArray(const std::string& string)
@@ -67,23 +78,48 @@ public:
         , m_count(string.size())
         , m_ref(ArrayFunctions<T>::newArrayObject(m_data, m_count))
         , m_elements(0)
+        , m_modified(false)
     {
     }
     PassArray(const std::vector<T>& vector)
-        : m_data(vector.data())
+        : m_data(vectorArrayData(vector))
         , m_count(vector.size())
-        , m_ref(ArrayFunctions<T>::newArrayObject(m_data, m_count))
+        , m_ref(newVectorArrayObject(vector))
         , m_elements(0)
+        , m_modified(false)
     {
     }
     ~PassArray()
     {
-        ArrayFunctions<T>::releaseArrayObjectElements(m_ref, m_elements, m_count);
+        ArrayFunctions<T>::releaseArrayObjectElements(m_ref, m_elements, m_count, m_modified);
         deleteArrayObject(m_ref);
     }
 
-    const T* data() const { return (m_data) ? m_data : (m_data = m_elements = ArrayFunctions<T>::getArrayObjectElements(m_ref)); }
+    // Elements read through data() are released without being copied back.
+    const T* data() const { return (m_data) ? m_data : fetchElements(); }
+    // Elements obtained through mutableData() are copied back into the array when released.
+    T* mutableData()
+    {
+        if (!m_elements)
+            fetchElements();
+        m_modified = true;
+        return m_elements;
+    }
+    // Drops to 0 once data() or mutableData() failed to fetch the elements; an exception is pending then.
     size_t count() const { return m_count; }
+    ref_t get() const { return m_ref; }
+
+    // Overwrites count elements from start without fetching the current contents.
+    void setRegion(size_t start, const T* data, size_t count)
+    {
+        if (m_elements) {
+            std::copy(data, data + count, m_elements + start);
+            m_modified = true;
+            return;
+        }
+        ArrayFunctions<T>::setArrayRegion(m_ref, start, count, data);
+        m_data = 0;
+    }
 
     ref_t leak() const
     {
@@ -93,10 +129,19 @@ public:
     }
 
 private:
+    T* fetchElements() const
+    {
+        m_data = m_elements = ArrayFunctions<T>::getArrayObjectElements(m_ref);
+        if (!m_elements)
+            m_count = 0;
+        return m_elements;
+    }
+
     mutable const T* m_data;
-    size_t m_count;
+    mutable size_t m_count;
     mutable ref_t m_ref;
     mutable T* m_elements;
+    bool m_modified;
 }; // class PassArray
 
 } // namespace JNI
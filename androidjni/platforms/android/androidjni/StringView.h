@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JavaVM.h"
+#include <androidjni/UTFConversion.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace JNI {
+
+// Views of a String parameter of a native method that live as long as the call
+// and spare creating a std::string for it. Both are movable but not copyable.
+
+// The UTF-16 characters of the string, held with GetStringChars.
+class Utf16View final {
+public:
+    Utf16View(JNIEnv* env, jstring string)
+        : m_env(env)
+        , m_string(string)
+        , m_data(string ? env->GetStringChars(string, NULL) : nullptr)
+        , m_size(m_data ? env->GetStringLength(string) : 0)
+    {
+    }
+    Utf16View(Utf16View&& other)
+        : m_env(other.m_env)
+        , m_string(other.m_string)
+        , m_data(other.m_data)
+        , m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    ~Utf16View()
+    {
+        if (m_data)
+            m_env->ReleaseStringChars(m_string, m_data);
+    }
+
+    const uint16_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return !m_size; }
+
+    std::u16string string() const { return std::u16string(reinterpret_cast<const char16_t*>(m_data), m_size); }
+#if __cplusplus >= 201703L
+    std::u16string_view view() const { return std::u16string_view(reinterpret_cast<const char16_t*>(m_data), m_size); }
+    operator std::u16string_view() const { return view(); }
+#endif
+
+private:
+    Utf16View(const Utf16View&) = delete;
+    Utf16View& operator=(const Utf16View&) = delete;
+
+    JNIEnv* m_env;
+    jstring m_string;
+    const jchar* m_data;
+    size_t m_size;
+}; // class Utf16View
+
+// The string transcoded to UTF-8 like toNative() does, into inline storage unless
+// it is longer than inlineCapacity bytes.
+class Utf8View final {
+public:
+    static const size_t inlineCapacity = 256;
+
+    Utf8View(JNIEnv* env, jstring string)
+        : m_data(m_inline)
+        , m_size(0)
+    {
+        if (!string)
+            return;
+
+        size_t length = env->GetStringLength(string);
+        if (length <= inlineCapacity) {
+            jchar chars[inlineCapacity];
+            env->GetStringRegion(string, 0, length, chars);
+            assign(chars, length);
+            return;
+        }
+
+        const jchar* chars = env->GetStringCritical(string, NULL);
+        if (!chars)
+            return;
+
+        assign(chars, length);
+        env->ReleaseStringCritical(string, chars);
+    }
+    Utf8View(Utf8View&& other)
+        : m_data(m_inline)
+        , m_size(other.m_size)
+        , m_heap(std::move(other.m_heap))
+    {
+        if (m_heap)
+            m_data = m_heap.get();
+        else
+            std::copy(other.m_inline, other.m_inline + m_size, m_inline);
+        other.m_data = other.m_inline;
+        other.m_size = 0;
+    }
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return !m_size; }
+
+    std::string string() const { return std::string(m_data, m_size); }
+#if __cplusplus >= 201703L
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+    operator std::string_view() const { return view(); }
+#endif
+
+private:
+    Utf8View(const Utf8View&) = delete;
+    Utf8View& operator=(const Utf8View&) = delete;
+
+    void assign(const uint16_t* chars, size_t length)
+    {
+        m_size = utf8Length(chars, length);
+        if (m_size > inlineCapacity) {
+            m_heap.reset(new char[m_size]);
+            m_data = m_heap.get();
+        }
+        utf16ToUTF8(chars, length, m_data);
+    }
+
+    char* m_data;
+    size_t m_size;
+    std::unique_ptr<char[]> m_heap;
+    char m_inline[inlineCapacity];
+}; // class Utf8View
+
+} // namespace JNI
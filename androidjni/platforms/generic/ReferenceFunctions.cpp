@@ -25,6 +25,8 @@
 
 #include <androidjni/ReferenceFunctions.h>
 
+#include <androidjni/ReferenceCensus.h>
+
 #include "ObjectReference.h"
 
 namespace JNI {
@@ -35,7 +37,9 @@ ref_t refLocal(ref_t ref)
         return 0;
 
     ObjectReference* bind = reinterpret_cast<ObjectReference*>(ref);
-    return bind->refLocal();
+    ref_t local = bind->refLocal();
+    REFERENCE_CENSUS_ADD(Local, local);
+    return local;
 }
 
 void derefLocal(ref_t ref)
@@ -43,6 +47,7 @@ void derefLocal(ref_t ref)
     if (!ref)
         return;
 
+    REFERENCE_CENSUS_REMOVE(Local, ref);
     ObjectReference* bind = reinterpret_cast<ObjectReference*>(ref);
     bind->derefLocal(bind);
 }
@@ -53,7 +58,9 @@ ref_t refGlobal(ref_t ref)
         return 0;
 
     ObjectReference* bind = reinterpret_cast<ObjectReference*>(ref);
-    return bind->refGlobal();
+    ref_t global = bind->refGlobal();
+    REFERENCE_CENSUS_ADD(Global, global);
+    return global;
 }
 
 void derefGlobal(ref_t ref)
@@ -61,6 +68,7 @@ void derefGlobal(ref_t ref)
     if (!ref)
         return;
 
+    REFERENCE_CENSUS_REMOVE(Global, ref);
     ObjectReference* bind = reinterpret_cast<ObjectReference*>(ref);
     bind->derefGlobal(bind);
 }
@@ -83,6 +91,7 @@ weak_t refWeakGlobal(ref_t ref)
 
     ObjectReference* bind = reinterpret_cast<ObjectReference*>(ref);
     bind->preventDeletion(true);
+    REFERENCE_CENSUS_ADD(WeakGlobal, ref);
     return reinterpret_cast<weak_t>(ref);
 }
 
@@ -92,48 +101,24 @@ void derefWeakGlobal(weak_t ref)
     if (!ref)
         return;
 
+    REFERENCE_CENSUS_REMOVE(WeakGlobal, ref);
     ObjectReference* bind = reinterpret_cast<ObjectReference*>(ref);
     bind->preventDeletion(false);
     bind->deleteIfPossible();
 }
 
-#if defined(_MSC_VER)
-#define thread_local __declspec(thread)
-#endif
-
-struct LocalCallerObject {
-    ref_t oref;
-    LocalCallerObject* next;
-};
-
-static thread_local LocalCallerObject localCallerObjects;
-
-ref_t popLocalCallerObjectRef()
+ref_t promoteWeakGlobal(weak_t ref)
 {
-    ref_t ref = 0;
-    std::swap(ref, localCallerObjects.oref);
-
-    if (!localCallerObjects.next)
-        return ref;
-
-    std::unique_ptr<LocalCallerObject> next(localCallerObjects.next);
-    localCallerObjects.oref = next->oref;
-    localCallerObjects.next = next->next;
-    return ref;
-}
+    if (!ref)
+        return 0;
 
-void pushLocalCallerObjectRef(ref_t ref)
-{
-    if (!localCallerObjects.oref) {
-        localCallerObjects.oref = ref;
-        return;
-    }
+    ObjectReference* bind = reinterpret_cast<ObjectReference*>(ref);
+    if (bind->isExpired())
+        return 0;
 
-    LocalCallerObject* next = new LocalCallerObject;
-    next->oref = localCallerObjects.oref;
-    next->next = localCallerObjects.next;
-    localCallerObjects.oref = ref;
-    localCallerObjects.next = next;
+    ref_t local = bind->refLocal();
+    REFERENCE_CENSUS_ADD(Local, local);
+    return local;
 }
 
 } // namespace JNI
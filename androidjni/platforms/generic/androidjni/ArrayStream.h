@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "PassArray.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+namespace JNI {
+
+static const size_t arrayStreamWindowBytes = 64 * 1024;
+
+// The elements are already in native memory on this platform, so windows point
+// straight into the array instead of being copied.
+template<typename T>
+class ArrayStreamReader final {
+public:
+    class Window {
+    public:
+        const T* data() const { return m_data; }
+        size_t count() const { return m_count; }
+        size_t offset() const { return m_offset; } // Relative to the start of the slice.
+
+        const T* begin() const { return m_data; }
+        const T* end() const { return m_data + m_count; }
+
+    private:
+        friend class ArrayStreamReader;
+        const T* m_data;
+        size_t m_count;
+        size_t m_offset;
+    };
+
+    class iterator {
+    public:
+        const Window& operator*() const { return m_reader->m_window; }
+        const Window* operator->() const { return &m_reader->m_window; }
+        iterator& operator++()
+        {
+            if (!m_reader->next())
+                m_reader = nullptr;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return m_reader == other.m_reader; }
+        bool operator!=(const iterator& other) const { return m_reader != other.m_reader; }
+
+    private:
+        friend class ArrayStreamReader;
+        explicit iterator(ArrayStreamReader* reader) : m_reader(reader) { }
+        ArrayStreamReader* m_reader;
+    };
+
+    explicit ArrayStreamReader(const PassArray<T>& array, size_t offset = 0, size_t length = SIZE_MAX, size_t windowSize = arrayStreamWindowBytes / sizeof(T))
+        : m_data(array.data())
+        , m_start(std::min(offset, array.count()))
+        , m_length(std::min(length, array.count() - m_start))
+        , m_position(0)
+        , m_windowSize(std::max<size_t>(1, windowSize))
+    {
+        m_window.m_data = m_data + m_start;
+        m_window.m_count = 0;
+        m_window.m_offset = 0;
+    }
+    // The windows point into the array's elements, which a temporary would free.
+    ArrayStreamReader(const PassArray<T>&&, size_t = 0, size_t = SIZE_MAX, size_t = 0) = delete;
+
+    size_t length() const { return m_length; }
+    size_t position() const { return m_position; }
+
+    bool next()
+    {
+        size_t count = std::min(m_windowSize, m_length - m_position);
+        m_window.m_data = m_data + m_start + m_position;
+        m_window.m_offset = m_position;
+        m_window.m_count = count;
+        m_position += count;
+        return count;
+    }
+    const Window& window() const { return m_window; }
+
+    iterator begin()
+    {
+        m_position = 0;
+        return next() ? iterator(this) : end();
+    }
+    iterator end() { return iterator(nullptr); }
+
+private:
+    ArrayStreamReader(const ArrayStreamReader&) = delete;
+    ArrayStreamReader& operator=(const ArrayStreamReader&) = delete;
+
+    const T* m_data;
+    size_t m_start;
+    size_t m_length;
+    size_t m_position;
+    size_t m_windowSize;
+    Window m_window;
+}; // class ArrayStreamReader
+
+// Gathers small writes in a buffer of windowSize elements, like the JNI
+// platform does, so writes show up in the array at the same flush points.
+template<typename T>
+class ArrayStreamWriter final {
+public:
+    explicit ArrayStreamWriter(PassArray<T>& array, size_t offset = 0, size_t length = SIZE_MAX, size_t windowSize = arrayStreamWindowBytes / sizeof(T))
+        : m_array(array)
+        , m_start(std::min(offset, array.count()))
+        , m_length(std::min(length, array.count() - m_start))
+        , m_position(0)
+        , m_capacity(std::max<size_t>(1, std::min(windowSize, m_length)))
+        , m_buffered(0)
+        , m_buffer(new T[m_capacity])
+    {
+    }
+    ~ArrayStreamWriter()
+    {
+        flush();
+    }
+
+    size_t length() const { return m_length; }
+    size_t position() const { return m_position + m_buffered; }
+
+    size_t write(const T* data, size_t count)
+    {
+        count = std::min(count, m_length - position());
+        if (m_buffered + count <= m_capacity) {
+            std::copy(data, data + count, m_buffer.get() + m_buffered);
+            m_buffered += count;
+            if (m_buffered == m_capacity)
+                flush();
+            return count;
+        }
+
+        flush();
+        m_array.setRegion(m_start + m_position, data, count);
+        m_position += count;
+        return count;
+    }
+    bool put(T value) { return write(&value, 1) == 1; }
+
+    void flush()
+    {
+        if (!m_buffered)
+            return;
+
+        m_array.setRegion(m_start + m_position, m_buffer.get(), m_buffered);
+        m_position += m_buffered;
+        m_buffered = 0;
+    }
+
+private:
+    ArrayStreamWriter(const ArrayStreamWriter&) = delete;
+    ArrayStreamWriter& operator=(const ArrayStreamWriter&) = delete;
+
+    PassArray<T>& m_array;
+    size_t m_start;
+    size_t m_length;
+    size_t m_position;
+    size_t m_capacity;
+    size_t m_buffered;
+    std::unique_ptr<T[]> m_buffer;
+}; // class ArrayStreamWriter
+
+} // namespace JNI
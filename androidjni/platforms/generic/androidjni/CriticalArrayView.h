@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace JNI {
+
+// Arrays are passed as vectors on this platform. Like a Java array, the vector is
+// shared with the caller, so writes through the view are seen by the caller.
+template<typename T>
+class CriticalArrayView final {
+    static_assert(std::is_arithmetic<T>::value, "CriticalArrayView requires a primitive element type");
+public:
+    explicit CriticalArrayView(const std::vector<T>& vector)
+        : m_data(const_cast<T*>(vector.data()))
+        , m_count(vector.size())
+    {
+    }
+
+    T* data() const { return m_data; }
+    size_t count() const { return m_count; }
+
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_count; }
+    T& operator[](size_t index) const { return m_data[index]; }
+
+private:
+    CriticalArrayView(const CriticalArrayView&) = delete;
+    CriticalArrayView& operator=(const CriticalArrayView&) = delete;
+
+    T* m_data;
+    size_t m_count;
+};
+
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "StringView.h"
+#include <androidjni/UTF16Functions.h>
+
+#include <cstring>
+#include <string>
+
+namespace JNI {
+
+// Strings are UTF-8 std::strings on this platform. Hash codes and indices are
+// still those of the UTF-16 form, so they match the Android results; searching
+// transcodes the string first.
+
+inline int32_t stringHashCode(const std::string& string)
+{
+    int32_t hash = 0;
+    forEachUTF16Chunk(string.data(), string.size(), [&](const uint16_t* units, size_t count) {
+        hash = javaHashCode(units, count, hash);
+        return true;
+    });
+    return hash;
+}
+
+inline bool stringEquals(const std::string& string, const char* other, size_t length)
+{
+    return string.size() == length && !memcmp(string.data(), other, length);
+}
+
+inline bool stringEquals(const std::string& string, const std::string& other)
+{
+    return string == other;
+}
+
+inline bool stringStartsWith(const std::string& string, const char* prefix, size_t length)
+{
+    return string.size() >= length && !memcmp(string.data(), prefix, length);
+}
+
+inline bool stringStartsWith(const std::string& string, const std::string& prefix)
+{
+    return stringStartsWith(string, prefix.data(), prefix.size());
+}
+
+inline ptrdiff_t stringIndexOf(const std::string& string, uint16_t c, size_t from = 0)
+{
+    Utf16View units(string);
+    return indexOf(units.data(), units.size(), c, from);
+}
+
+inline ptrdiff_t stringIndexOf(const std::string& string, const uint16_t* needle, size_t needleLength, size_t from = 0)
+{
+    Utf16View units(string);
+    return indexOf(units.data(), units.size(), needle, needleLength, from);
+}
+
+} // namespace JNI
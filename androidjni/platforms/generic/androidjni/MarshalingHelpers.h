@@ -25,7 +25,12 @@
 
 #pragma once
 
+#include "ArrayStream.h"
+#include "CriticalArrayView.h"
+#include "JavaStringFunctions.h"
+#include "LocalFrame.h"
 #include "PassArray.h"
+#include "StringView.h"
 #include "ObjectReference.h"
 #include <androidjni/PassLocalRef.h>
 
@@ -50,7 +55,7 @@ std::shared_ptr<T> toManaged(const PassLocalRef<U>& ref)
 }
 
 template<typename T, typename U>
-PassLocalRef<T> toNative(std::shared_ptr<U>& ref)
+PassLocalRef<T> toNative(const std::shared_ptr<U>& ref)
 {
     return (ref) ? T::fromPtr(ref) : nullptr;
 }
@@ -60,9 +65,9 @@ template<> inline std::shared_ptr<void> toManaged(const PassLocalRef<AnyObject>&
     return sharePtr(ref.get());
 }
 
-template<> inline PassLocalRef<AnyObject> toNative(std::shared_ptr<void>& ref)
+template<> inline PassLocalRef<AnyObject> toNative(const std::shared_ptr<void>& ref)
 {
-    return JNI::adoptRef(new ObjectReference(ref), reinterpret_cast<AnyObject*>(nullptr));
+    return JNI::adoptRef(new ObjectReference(ref), static_cast<AnyObject*>(nullptr));
 }
 
 template<typename T>
@@ -77,10 +82,15 @@ inline PassArray<T> toNative(std::vector<T>& value)
     return PassArray<T>(value.data(), value.size(), true);
 }
 
+inline PassArray<bool> toNative(std::vector<bool>& value)
+{
+    return PassArray<bool>(value);
+}
+
 template<typename T, typename U>
 inline std::vector<std::shared_ptr<T>> toManaged(PassArray<PassLocalRef<U>> value)
 {
-    return value.vectorize<T>();
+    return value.template vectorize<T>();
 }
 
 }
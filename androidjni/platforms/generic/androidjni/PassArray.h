@@ -27,11 +27,17 @@
 
 #include <androidjni/AnyObject.h>
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <memory>
 #include <vector>
 
 namespace JNI {
 
+template<typename T> class PassLocalRef;
+template<typename T, typename U> std::shared_ptr<T> toManaged(const PassLocalRef<U>& ref);
+
 template<typename T>
 class JNI_EXPORT PassArray final {
 public:
@@ -50,12 +56,14 @@ public:
     {
         std::swap(m_copy, array.m_copy);
     }
+    // Copies element-wise so that the packed std::vector<bool> works as well.
     PassArray(const std::vector<T>& vector)
-        : m_data(vector.data())
+        : m_data(0)
         , m_count(vector.size())
-        , m_copy(0)
+        , m_copy(new T[vector.size()])
     {
-        copyData();
+        std::copy(vector.begin(), vector.end(), m_copy);
+        m_data = m_copy;
     }
     ~PassArray()
     {
@@ -63,8 +71,20 @@ public:
     }
 
     const T* data() const { return m_data; }
+    // Writes go to a private copy of the elements.
+    T* mutableData()
+    {
+        if (!m_copy)
+            copyData();
+        return m_copy;
+    }
     size_t count() const { return m_count; }
 
+    void setRegion(size_t start, const T* data, size_t count)
+    {
+        std::copy(data, data + count, mutableData() + start);
+    }
+
     template<typename U>
     std::vector<std::shared_ptr<U>> vectorize()
     {
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <androidjni/UTFConversion.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace JNI {
+
+// Strings are passed as std::string on this platform, so the UTF-8 view refers to
+// the caller's string, while the UTF-16 view holds a transcoded copy.
+
+class Utf8View final {
+public:
+    Utf8View(const std::string& string)
+        : m_data(string.data())
+        , m_size(string.size())
+    {
+    }
+    Utf8View(Utf8View&&) = default;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return !m_size; }
+
+    std::string string() const { return std::string(m_data, m_size); }
+#if __cplusplus >= 201703L
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+    operator std::string_view() const { return view(); }
+#endif
+
+private:
+    Utf8View(const Utf8View&) = delete;
+    Utf8View& operator=(const Utf8View&) = delete;
+
+    const char* m_data;
+    size_t m_size;
+}; // class Utf8View
+
+class Utf16View final {
+public:
+    Utf16View(const std::string& string)
+        : m_chars(string.size())
+    {
+        m_chars.resize(utf8ToUTF16(string.data(), string.size(), m_chars.data()));
+    }
+    Utf16View(Utf16View&&) = default;
+
+    const uint16_t* data() const { return m_chars.data(); }
+    size_t size() const { return m_chars.size(); }
+    bool empty() const { return m_chars.empty(); }
+
+    std::u16string string() const { return std::u16string(m_chars.begin(), m_chars.end()); }
+#if __cplusplus >= 201703L
+    std::u16string_view view() const { return std::u16string_view(reinterpret_cast<const char16_t*>(m_chars.data()), m_chars.size()); }
+    operator std::u16string_view() const { return view(); }
+#endif
+
+private:
+    Utf16View(const Utf16View&) = delete;
+    Utf16View& operator=(const Utf16View&) = delete;
+
+    std::vector<uint16_t> m_chars;
+}; // class Utf16View
+
+} // namespace JNI
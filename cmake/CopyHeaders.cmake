@@ -0,0 +1,3 @@
+# Copies the headers under SOURCE_DIR to DESTINATION_DIR, keeping the directory layout.
+# Usage: cmake -DSOURCE_DIR=<dir> -DDESTINATION_DIR=<dir> -P CopyHeaders.cmake
+file(COPY "${SOURCE_DIR}/" DESTINATION "${DESTINATION_DIR}" FILES_MATCHING PATTERN "*.h" PATTERN "*.hpp")
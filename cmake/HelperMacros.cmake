@@ -57,7 +57,7 @@ macro(COPY_LIBRARY_HEADERS_DIRECTORY _target _source _destination)
         file(APPEND "${${_target}_POST_BUILD_COMMAND}" "IF %ERRORLEVEL% LEQ 3 set ERRORLEVEL=0\n")
     else ()
         add_custom_command(TARGET ${_target} POST_BUILD COMMAND echo Copying ${_target} library headers... VERBATIM)
-        add_custom_command(TARGET ${_target} POST_BUILD COMMAND mkdir -p ${CMAKE_LIBRARY_OUTPUT_DIRECTORY}/../${_destination} && rsync -rpuL --include='*.h' --include='*.hpp' --exclude='*.*' ${_absolute}/* ${CMAKE_LIBRARY_OUTPUT_DIRECTORY}/../${_destination})
+        add_custom_command(TARGET ${_target} POST_BUILD COMMAND ${CMAKE_COMMAND} -DSOURCE_DIR=${_absolute} -DDESTINATION_DIR=${CMAKE_LIBRARY_OUTPUT_DIRECTORY}/../${_destination} -P ${CMAKE_SOURCE_DIR}/cmake/CopyHeaders.cmake VERBATIM)
     endif ()
 endmacro()
 
@@ -0,0 +1,30 @@
+# On a Linux host the generic platform is built by default. With ENABLE_HOST_JNI
+# the JNI platform is built against a desktop JDK instead, so that the JNI code,
+# the generated stubs and the test library run off-device.
+set(CMAKE_ARCHIVE_OUTPUT_DIRECTORY ${CMAKE_ARCHIVE_OUTPUT_DIRECTORY}/lib)
+set(CMAKE_LIBRARY_OUTPUT_DIRECTORY ${CMAKE_LIBRARY_OUTPUT_DIRECTORY}/lib)
+set(CMAKE_RUNTIME_OUTPUT_DIRECTORY ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/bin)
+
+option(ENABLE_HOST_JNI "Build the JNI platform against the JDK under JAVA_HOME instead of the generic platform" OFF)
+set(JAVA_HOME "$ENV{JAVA_HOME}" CACHE PATH "Path to the JDK the host JNI platform is built against.")
+
+if (ENABLE_HOST_JNI AND NOT EXISTS "${JAVA_HOME}/include/jni.h")
+    message(FATAL_ERROR "ENABLE_HOST_JNI needs a JDK, but there is no jni.h under JAVA_HOME (${JAVA_HOME}).")
+endif ()
+
+set(CMAKE_CXX_STANDARD 14)
+set(CMAKE_CXX_STANDARD_REQUIRED ON)
+set(CMAKE_POSITION_INDEPENDENT_CODE ON)
+
+find_package(Threads REQUIRED)
+
+if (ENABLE_HOST_JNI)
+    include_directories(
+        "${JAVA_HOME}/include"
+        "${JAVA_HOME}/include/linux"
+    )
+
+    set(ENV{JAVA_HOME} "${JAVA_HOME}")
+    find_package(Java 1.7 REQUIRED COMPONENTS Development)
+    include(UseJava)
+endif ()
@@ -120,11 +120,14 @@ def getInitializerValue(initializer, base_type):
         return initializer.sign + initializer.expression.value
 
 class Parameter:
-    def __init__(self, is_final=False, base_type=None, dimensions=0, name=None):
+    def __init__(self, is_final=False, base_type=None, dimensions=0, name=None, is_critical=False, is_interned=False, string_view=None):
         self.is_final = is_final
         self.base_type = base_type
         self.dimensions = dimensions
         self.name = name
+        self.is_critical = is_critical
+        self.is_interned = is_interned
+        self.string_view = string_view
 
 def makeParameter(formal_parameter):
     parameter = Parameter()
@@ -132,6 +135,12 @@ def makeParameter(formal_parameter):
     parameter.base_type = getTypeName(formal_parameter.type)
     parameter.dimensions = getTypeDimensions(formal_parameter.type)
     parameter.name = formal_parameter.variable.name
+    parameter.is_critical = hasAnnotation(formal_parameter, 'CriticalArray')
+    if parameter.is_critical:
+        assert(parameter.dimensions == 1 and parameter.base_type in critical_array_types)
+    parameter.is_interned = hasAnnotation(formal_parameter, 'Interned')
+    if parameter.is_interned:
+        assert(parameter.dimensions == 0 and isStringType(parameter.base_type))
     return parameter
 
 def makeParameterList(declaration):
@@ -141,6 +150,9 @@ def makeParameterList(declaration):
     return parameters
 
 tab_character = '    '
+critical_array_types = ['byte', 'short', 'char', 'int', 'long', 'float', 'double']
+string_view_types = {'utf8': 'JNI::Utf8View', 'utf16': 'JNI::Utf16View'}
+string_view_type = None # Set by --string-views.
 natives_files_suffix = 'Natives'
 managed_files_suffix = 'Managed'
 any_object = '$ANYOBJECT'
@@ -242,12 +254,16 @@ class GeneratorBackendOverrides:
     def hasManaged(self):
         return False
 
-    def commonBaseClass(self):
+    def commonBaseClass(self, native_ref_count):
         return None
 
     def managedObjectType(self):
         return 'void*'
 
+    # Statements run before nativeObjectRef() returns an empty ref for a destroyed object.
+    def destroyedNativeObjectStatements(self):
+        return []
+
     def forbidOverrideNativeMethod(self):
         return False
 
@@ -269,6 +285,12 @@ class GeneratorBackendOverrides:
     def internalArrayObject(self, base_type):
         return base_type
 
+    def internalCriticalArrayObject(self, base_type):
+        return self.internalArrayObject(base_type)
+
+    def internalStringView(self, string_type, view_type):
+        return string_type
+
     def internalTypeOfAnyObject(self):
         return 'void*'
 
@@ -404,8 +426,14 @@ class GeneratorBackend:
             external_type = self.overrides.externalTypeOfObject(external_type)
         return external_type
 
-    def resolvePassType(self, base_type, type_dimensions, as_reference):
+    def resolvePassType(self, base_type, type_dimensions, as_reference, is_critical=False, is_interned=False, string_view=None):
         internal_type = self.resolveInternalType(base_type, type_dimensions)
+        if is_critical:
+            return ''.join(["const ", self.overrides.internalCriticalArrayObject(internal_type), '&'])
+        if is_interned:
+            return 'const JNI::InternedString&'
+        if string_view:
+            return ''.join(["const ", self.overrides.internalStringView(internal_type, string_view), '&'])
         if isObjectType(base_type):
             self.maybeUnknownTypeOfValue(base_type)
             native_type = self.overrides.internalPassObject(internal_type)
@@ -420,7 +448,7 @@ class GeneratorBackend:
 
     def surroundWithCast(self, base_type, type_dimensions, term, is_outbound=True):
         ts = self.overrides.outboundTypeCast() if is_outbound else self.overrides.inboundTypeCast()
-        if not isPrimitiveType(base_type) and not isStringType(base_type):
+        if not isPrimitiveType(base_type) and not isStringType(base_type) and not isDirectBufferType(base_type):
             if is_outbound:
                 ts = ''.join([ts, '<', self.resolveExternalType(base_type, type_dimensions), '>'])
             else:
@@ -454,7 +482,10 @@ class GeneratorBackend:
         arguments = []
         if len(parameters) > 0:
             for parameter in parameters:
-                arguments.append(self.surroundWithCast(parameter.base_type, parameter.dimensions, parameter.name, is_outbound))
+                if parameter.is_critical:
+                    arguments.append('JNI::CriticalArrayView<%s>(%s)' % (self.resolveInternalType(parameter.base_type, parameter.dimensions), parameter.name))
+                else:
+                    arguments.append(self.surroundWithCast(parameter.base_type, parameter.dimensions, parameter.name, is_outbound))
         return arguments
 
     def buildMethodReturn(self, return_type):
@@ -462,7 +493,7 @@ class GeneratorBackend:
 
     def buildParameter(self, parameter, call_by_reference):
         parameter_name = "" if parameter.name == "" else ' ' + parameter.name
-        return self.resolvePassType(parameter.base_type, parameter.dimensions, call_by_reference) + parameter_name
+        return self.resolvePassType(parameter.base_type, parameter.dimensions, call_by_reference, parameter.is_critical, parameter.is_interned, parameter.string_view) + parameter_name
 
     def buildParameters(self, parameters, call_by_reference):
         if len(parameters) > 0:
@@ -521,7 +552,7 @@ class GeneratorBackend:
         LOG.V('processNamespaceEnd: ' + name)
         self.namespace_stack.pop()
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
         LOG.V('processClassBegin: ' + name)
         self.class_attribute_stack.append(self.class_attribute)
         self.class_name_stack.append(name)
@@ -599,13 +630,18 @@ def isStringType(typename):
         return True
     return False
 
+def isDirectBufferType(typename):
+    if typename == 'ByteBuffer':
+        return True
+    return False
+
 def isAnyObjectType(typename):
     if typename == 'Object':
         return True
     return False
 
 def isObjectType(typename):
-    return isAnyObjectType(typename) or (not isPrimitiveType(typename) and not isStringType(typename))
+    return isAnyObjectType(typename) or (not isPrimitiveType(typename) and not isStringType(typename) and not isDirectBufferType(typename))
 
 class TypeMap:
     def __init__(self):
@@ -634,12 +670,14 @@ class CPPTypeMap(TypeMap):
         self.mapType('int',     ['int32_t'])
         self.mapType('long',    ['int64_t'])
         self.mapType('short',   ['int16_t'])
+        self.mapType('char',    ['uint16_t'])
         self.mapType('byte',    ['int8_t'])
         self.mapType('float',   ['float'])
         self.mapType('double',  ['double'])
         self.mapType('boolean', ['bool'])
         self.mapType('Object',  [any_object])
         self.mapType('String',  [cpp_string])
+        self.mapType('ByteBuffer', ['JNI::DirectBuffer'])
 
 cpp_type_map = CPPTypeMap()
 
@@ -653,12 +691,14 @@ class CallTypeMap(TypeMap):
         self.mapType('int',     ["Int"])
         self.mapType('long',    ["Long"])
         self.mapType('short',   ["Short"])
+        self.mapType('char',    ["Char"])
         self.mapType('byte',    ["Byte"])
         self.mapType('float',   ["Float"])
         self.mapType('double',  ["Double"])
         self.mapType('boolean', ["Boolean"])
         self.mapType('void*',   ['Object'])
         self.mapType('String',  ["String"])
+        self.mapType('ByteBuffer', ["ByteBuffer"])
 
     def defaultType(self, typename):
         return 'Object'
@@ -678,12 +718,14 @@ class JNITypeMap(TypeMap):
         self.mapType('int',     ['jint'])
         self.mapType('long',    ['jlong'])
         self.mapType('short',   ['jshort'])
+        self.mapType('char',    ['jchar'])
         self.mapType('byte',    ['jbyte'])
         self.mapType('float',   ['jfloat'])
         self.mapType('double',  ['jdouble'])
         self.mapType('boolean', ['jboolean'])
         self.mapType('Object',  ['jobject'])
         self.mapType('String',  ['jstring'])
+        self.mapType('ByteBuffer', ['jbytebuffer'])
 
     def defaultType(self, typename):
         return 'jobject'
@@ -703,12 +745,14 @@ class JNISignatureMap(TypeMap):
         self.mapType('int',     ['I'])
         self.mapType('long',    ['J'])
         self.mapType('short',   ['S'])
+        self.mapType('char',    ['C'])
         self.mapType('byte',    ['B'])
         self.mapType('float',   ['F'])
         self.mapType('double',  ['D'])
         self.mapType('boolean', ['Z'])
         self.mapType('Object',  ['Ljava/lang/Object;'])
         self.mapType('String',  ['Ljava/lang/String;'])
+        self.mapType('ByteBuffer', ['Ljava/nio/ByteBuffer;'])
 
     def defaultType(self, typename):
         return "L\" PACKAGE_NAME \"/" + typename + ";"
@@ -749,6 +793,16 @@ class GeneratorFrontend:
             self.backend.processNamespaceEnd(word)
 
     def processMethod(self, called_by_native, is_static, is_abstract, is_native, return_type, name, parameters):
+        if any(parameter.is_critical for parameter in parameters):
+            # Nothing that calls into JNI may run while critical arrays are held.
+            assert(is_native)
+            assert(getTypeDimensions(return_type) == 0 and (isPrimitiveType(getTypeName(return_type)) or isStringType(getTypeName(return_type))))
+            for parameter in parameters:
+                assert(parameter.is_critical or parameter.dimensions == 0 and (isPrimitiveType(parameter.base_type) or isStringType(parameter.base_type)))
+        if is_native and string_view_type:
+            for parameter in parameters:
+                if isStringType(parameter.base_type) and parameter.dimensions == 0 and not parameter.is_interned:
+                    parameter.string_view = string_view_type
         self.backend.processNativeMethod(is_static, is_abstract, return_type, name, parameters) if is_native else self.backend.processMethod(called_by_native, is_static, is_abstract, return_type, name, parameters)
 
     def processClass(self, type_declaration):
@@ -782,8 +836,9 @@ class GeneratorFrontend:
         has_trivial_constructor = hasTrivialConstructor()
 
         native_export_macro = getAnnotationValue(type_declaration, 'NativeExportMacro') if hasAnnotation(type_declaration, 'NativeExportMacro') else None
+        native_ref_count = getAnnotationValue(type_declaration, 'NativeRefCount') if hasAnnotation(type_declaration, 'NativeRefCount') else None
 
-        self.backend.processClassBegin(type_declaration.name, native_export_macro, getTypeName(type_declaration.extends),
+        self.backend.processClassBegin(type_declaration.name, native_export_macro, native_ref_count, getTypeName(type_declaration.extends),
                                        class_type_parameters, has_trivial_constructor, hasNativeConstructors())
 
         if has_trivial_constructor:
@@ -797,6 +852,7 @@ class GeneratorFrontend:
                 if hasAnnotation(declaration, 'NativeConstructor'):
                     assert(not hasModifier(declaration, 'static'))
                     assert(declaration.return_type == 'void')
+                    assert(not any(parameter.is_critical for parameter in makeParameterList(declaration)))
                     self.backend.processNativeConstructor(declaration.name
                                                           , makeParameterList(declaration)
                                                           , hasAnnotation(declaration, 'AbstractMethod'))
@@ -920,11 +976,11 @@ class InterfaceHeaderGeneratorBackend(HeaderGeneratorBackend):
                                              })
         self.puts(ts)
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
-        HeaderGeneratorBackend.processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+        HeaderGeneratorBackend.processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
 
         extends = None  # Disable extends
-        base_class = extends if extends is not None else self.overrides.commonBaseClass()
+        base_class = extends if extends is not None else self.overrides.commonBaseClass(native_ref_count)
 
         if extends is not None and extends not in self.unknown_parameter_types:
             self.unknown_parameter_types.append(extends)
@@ -1100,8 +1156,11 @@ class NativesHeaderGeneratorBackendOverrides(GeneratorBackendOverrides):
     def __init__(self):
         GeneratorBackendOverrides.__init__(self)
 
-    def commonBaseClass(self):
-        return 'JNI::NativeObject'
+    def commonBaseClass(self, native_ref_count):
+        if native_ref_count is None:
+            native_ref_count = 'Atomic'
+        assert(native_ref_count in ('Atomic', 'ThreadConfined'))
+        return 'JNI::RefCountedNativeObject<JNI::%sRefCount>' % native_ref_count
 
     def abstractNativeMethodModifier(self):
         return ' = 0'
@@ -1118,6 +1177,12 @@ class NativesHeaderGeneratorBackendOverrides(GeneratorBackendOverrides):
     def internalArrayObject(self, base_type):
         return 'JNI::PassArray<$T>'.replace('$T', base_type)
 
+    def internalCriticalArrayObject(self, base_type):
+        return 'JNI::CriticalArrayView<$T>'.replace('$T', base_type)
+
+    def internalStringView(self, string_type, view_type):
+        return view_type
+
     def internalTypeOfAnyObject(self):
         return 'JNI::AnyObject'
 
@@ -1171,8 +1236,8 @@ class NativesHeaderGeneratorBackend(InterfaceHeaderGeneratorBackend):
         self.puts("$CLASS_IMPORT_HEADERS")
         self.EOL()
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
-        InterfaceHeaderGeneratorBackend.processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+        InterfaceHeaderGeneratorBackend.processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
 
         self.INC()
         if not self.class_attribute.has_native_constructors:
@@ -1182,7 +1247,7 @@ class NativesHeaderGeneratorBackend(InterfaceHeaderGeneratorBackend):
             self.EOL()
         ts = (
         "static $LOCAL_REF<$CLASS_PATH> fromRef(JNI::ref_t);",
-        "static $LOCAL_REF<$CLASS_PATH> fromPtr(std::shared_ptr<$EXTERNAL_NAMESPACE::$CLASS_PATH>&);",
+        "static $LOCAL_REF<$CLASS_PATH> fromPtr(std::shared_ptr<$EXTERNAL_NAMESPACE::$CLASS_PATH>);",
         "")
         self.puts('\n'.join(ts))
         self.DEC()
@@ -1258,8 +1323,8 @@ class ManagedHeaderGeneratorBackend(InterfaceHeaderGeneratorBackend):
             self.puts("CLASS_EXPORT virtual void INIT(%1);\n", self.buildParameters(constructor, True))
         self.EOL()
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
-        InterfaceHeaderGeneratorBackend.processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+        InterfaceHeaderGeneratorBackend.processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
 
         ts = (
         "template<typename T, typename... Args> static inline std::shared_ptr<T> create(Args&&... arguments)",
@@ -1283,6 +1348,8 @@ class ManagedHeaderGeneratorBackend(InterfaceHeaderGeneratorBackend):
     def processFileHeader(self, name):
         InterfaceHeaderGeneratorBackend.processFileHeader(self, name)
         ts = (
+        "#include <androidjni/DirectBuffer.h>",
+        "#include <androidjni/InternedString.h>",
         "#include <functional>",
         "#include <map>",
         "#include <memory>",
@@ -1390,8 +1457,8 @@ class StubGeneratorBackend(GeneratorBackend):
         GeneratorBackend.processNamespaceEnd(self, name)
         self.puts("} // namespace %1\n", name)
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
-        GeneratorBackend.processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+        GeneratorBackend.processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
         ts = (
         "namespace $INTERNAL_NAMESPACE {",
         "",
@@ -1434,10 +1501,12 @@ class StubGeneratorBackend(GeneratorBackend):
         self.puts('\n'.join(ts), managed_object_type)
 
         if self.class_attribute.has_native_constructors:
-            ts = ("",
-            "    JNI::NativeObject* nativeObject = reinterpret_cast<JNI::NativeObject*>(nativeObjectFieldGet(thisObject));",
-            "    $ASSERT(nativeObject);",
-            "    nativeObject->ref();")
+            ts = ["",
+            "    JNI::NativeObject* nativeObject = JNI::refNativeObjectField(nativeObjectFieldGet(thisObject));",
+            "    if (!nativeObject) {"]
+            ts += ["        " + statement for statement in self.overrides.destroyedNativeObjectStatements()]
+            ts += ["        return $LOCAL_REF<Natives::$CLASS_PATH>(); // Already destroyed.",
+            "    }"]
         else:
             ts = ("",
             "    JNI::pushLocalCallerObjectRef(thisObject);",
@@ -1671,8 +1740,8 @@ class NativesCPPStubGeneratorBackend(StubGeneratorBackend):
         self.EOL()
         self.EOL()
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
-        StubGeneratorBackend.processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+        StubGeneratorBackend.processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
 
         ts = (
         "$LOCAL_REF<$CLASS_PATH> $CLASS_PATH::fromRef(JNI::ref_t ref)",
@@ -1680,9 +1749,9 @@ class NativesCPPStubGeneratorBackend(StubGeneratorBackend):
         "    return nativeObject(ref);",
         "}",
         "",
-        "$LOCAL_REF<$CLASS_PATH> $CLASS_PATH::fromPtr(std::shared_ptr<$EXTERNAL_NAMESPACE::$CLASS_PATH>& ptr)",
+        "$LOCAL_REF<$CLASS_PATH> $CLASS_PATH::fromPtr(std::shared_ptr<$EXTERNAL_NAMESPACE::$CLASS_PATH> ptr)",
         "{",
-        "    return fromRef(reinterpret_cast<$CLASS_NAME*>(ptr->$NATIVE_OBJECT_FIELD)->refLocal());" if has_native_constructors else "    return fromRef(new JNI::ObjectReference(std::move(ptr)));",
+        "    return fromRef(JNI::nativeObjectFromField(ptr->$NATIVE_OBJECT_FIELD)->refLocal());" if has_native_constructors else "    return fromRef(new JNI::ObjectReference(std::move(ptr)));",
         "}",
         "")
         self.puts('\n'.join(ts))
@@ -1698,6 +1767,11 @@ class NativesJNIStubGeneratorBackendOverrides(NativesCPPStubGeneratorBackendOver
     def managedObjectType(self):
         return 'jobject'
 
+    def destroyedNativeObjectStatements(self):
+        return ["JNIEnv* env = JNI::getEnv();",
+                "if (!env->ExceptionCheck())",
+                "    env->ThrowNew(env->FindClass(\"java/lang/IllegalStateException\"), \"$CLASS_NAME used after its native object was destroyed\");"]
+
     def externalTypeOfAnyObject(self):
         return 'jobject'
 
@@ -1730,19 +1804,22 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
                 result += '\n' + tabs + ', ' + buildJNIParameter(parameter)
         return result
 
-    def buildJNIArguments(self, parameters, indention=0):
-        def buildJNIArgument(parameter):
-            to_object = ("<" + self.resolveInternalType(parameter.base_type, parameter.dimensions) + ">") if isObjectType(parameter.base_type) else ""
-            return "JNI::toNative" + to_object + '(' + parameter.name + ')'
+    def buildJNIArgument(self, parameter):
+        if parameter.string_view:
+            return '%s(env, %s)' % (parameter.string_view, parameter.name)
+        to_object = ("<" + self.resolveInternalType(parameter.base_type, parameter.dimensions) + ">") if isObjectType(parameter.base_type) else ""
+        with_env = "env, " if (isStringType(parameter.base_type) or isDirectBufferType(parameter.base_type)) and parameter.dimensions == 0 else ""
+        return "JNI::toNative" + to_object + '(' + with_env + parameter.name + ')'
 
+    def buildJNIArguments(self, parameters, indention=0):
         result = ""
         tabs = tab_character * (self.indention + indention)
         if len(parameters) > 0:
             first_parameter = parameters[0]
             next_parameters = parameters[1:]
-            result += buildJNIArgument(first_parameter)
+            result += self.buildJNIArgument(first_parameter)
             for parameter in next_parameters:
-                result += '\n' + tabs + ', ' + buildJNIArgument(parameter)
+                result += '\n' + tabs + ', ' + self.buildJNIArgument(parameter)
         return result
 
     def buildJNISignature(self, base_type, dimensions):
@@ -1787,7 +1864,8 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
         if len(self.native_method_registry) > 0:
             native_methods = []
             for native_method in self.native_method_registry:
-                native_methods.append(''.join(["{ \"", native_method.name, "\", \"", native_method.signatures, "\",\n"]))
+                # Desktop jni.h declares the name and signature as char*.
+                native_methods.append(''.join(["{ const_cast<char*>(\"", native_method.name, "\"), const_cast<char*>(\"", native_method.signatures, "\"),\n"]))
                 native_methods.append(''.join(["  (void*)$CLASS_NAME::NativeBindings::", native_method.function_name, " },\n"]))
 
             ts = (
@@ -1833,17 +1911,25 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
         self.native_method_registry.append(NativeMethodRegistry(name, self.buildJNISignatures(parameters, 'void'), name))
 
         ts = (
-        "static void %1(JNIEnv*, jobject scope$PRECEDING_COMMA$JNI_PARAMETERS)",
+        "static void %1(JNIEnv* env, jobject scope$PRECEDING_COMMA$JNI_PARAMETERS)",
         "{",
+        "    JNI::ScopedEnv scopedEnv(env);",
         "    JNI::pushLocalCallerObjectRef(scope);",
         "    auto* nativePtr = $CLASS_PATH::%1($JNI_ARGUMENTS);",
-        "    nativePtr->$NATIVE_OBJECT_FIELD.set(reinterpret_cast<jint>(nativePtr)); // Reference adopted",
+        "    auto nativeObjectField = JNI::adoptNativeObjectField<$NATIVE_OBJECT_FIELD_TYPE>(nativePtr); // Reference adopted",
+        "    if (!nativeObjectField) {",
+        "        nativePtr->deref();",
+        "        env->ThrowNew(env->FindClass(\"java/lang/OutOfMemoryError\"), \"No native object handle left for $CLASS_NAME\");",
+        "        return;",
+        "    }",
+        "    nativePtr->$NATIVE_OBJECT_FIELD.set(nativeObjectField);",
         "}")
         ts = string.Template('\n'.join(ts)).safe_substitute({
                                              'PRECEDING_COMMA' : ', ' if len(parameters) > 0 else '',
                                              'JNI_PARAMETERS' : self.buildJNIParameters(parameters),
                                              'JNI_ARGUMENTS' : self.buildJNIArguments(parameters, 1),
                                              'NATIVE_OBJECT_FIELD' : self.class_attribute.native_object_field.name,
+                                             'NATIVE_OBJECT_FIELD_TYPE' : self.resolveInternalType(self.class_attribute.native_object_field.base_type, 0),
                                              })
         self.puts(ts, name)
         self.EOL()
@@ -1853,9 +1939,12 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
         self.native_method_registry.append(NativeMethodRegistry(name, self.buildJNISignatures([], 'void'), name))
 
         ts = (
-        "static void %1(JNIEnv*, jobject scope)",
+        "static void %1(JNIEnv* env, jobject scope)",
         "{",
-        "    reinterpret_cast<Natives::$CLASS_PATH*>(nativeObjectFieldGet(scope))->deref();",
+        "    JNI::ScopedEnv scopedEnv(env);",
+        "    JNI::NativeObject* nativeObject = JNI::releaseNativeObjectField(nativeObjectFieldGet(scope));",
+        "    if (nativeObject)",
+        "        nativeObject->deref();",
         "}")
         self.puts('\n'.join(ts), name)
         self.EOL()
@@ -1865,7 +1954,7 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
 
         has_result = return_type != 'void'
 
-        ts = ("static $JNI_TYPE $METHOD_NAME(JNIEnv*, $JNI_SCOPE$PRECEDING_COMMA$JNI_PARAMETERS)")
+        ts = ("static $JNI_TYPE $METHOD_NAME(JNIEnv* env, $JNI_SCOPE$PRECEDING_COMMA$JNI_PARAMETERS)")
         ts = string.Template(''.join(ts)).safe_substitute({
                                              'JNI_TYPE' : self.resolveExternalType(getTypeName(return_type), getTypeDimensions(return_type)),
                                              'METHOD_NAME' : name,
@@ -1876,19 +1965,67 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
         self.puts(ts)
         self.EOL()
 
+        if any(parameter.is_critical for parameter in parameters):
+            self.implementCriticalNativeBinding(is_static, return_type, name, parameters)
+            return
+
+        # nativeObject() is empty once the native object was destroyed, so bail out with a default result.
+        checks_native_this = not is_static and self.class_attribute.has_native_constructors
+
         ts = ("$SCOPE$ACCESSING_OPERATOR$METHOD_NAME($JNI_ARGUMENTS)")
         ts = string.Template(''.join(ts)).safe_substitute({
-                                             'SCOPE' : self.classPath() if is_static else "nativeObject(scope)",
+                                             'SCOPE' : self.classPath() if is_static else ("nativeThis" if checks_native_this else "nativeObject(scope)"),
                                              'ACCESSING_OPERATOR' : '::' if is_static else '->',
                                              'METHOD_NAME' : name,
                                              'JNI_ARGUMENTS' : self.buildJNIArguments(parameters, 1),
                                              })
-        if has_result:
+        if has_result and (isStringType(getTypeName(return_type)) or isDirectBufferType(getTypeName(return_type))) and getTypeDimensions(return_type) == 0:
+            ts = ''.join(['return JNI::toManaged(env, ', ts, ')'])
+        elif has_result:
             ts = ''.join(['return ', self.surroundWithCast(getTypeName(return_type), getTypeDimensions(return_type), ts, True)])
-        ts = '\n'.join(['{', tab_character + ts + ';', '}'])
+        prologue = [tab_character + "JNI::ScopedEnv scopedEnv(env);"]
+        if checks_native_this:
+            prologue += [tab_character + "auto nativeThis = nativeObject(scope);",
+                         tab_character + "if (!nativeThis)",
+                         tab_character * 2 + ("return {};" if has_result else "return;")]
+        ts = '\n'.join(['{'] + prologue + [tab_character + ts + ';', '}'])
         self.puts(ts)
         self.EOL()
 
+    # Converts every other argument first and pins the critical arrays only around the
+    # call itself, since no JNI function may be used while they are held.
+    def implementCriticalNativeBinding(self, is_static, return_type, name, parameters):
+        def nativeArgument(parameter):
+            return 'native' + parameter.name[0].upper() + parameter.name[1:]
+
+        has_result = return_type != 'void'
+
+        ts = ['{', "    JNI::ScopedEnv scopedEnv(env);"]
+        if not is_static:
+            ts.append("    auto nativeThis = nativeObject(scope);")
+            if self.class_attribute.has_native_constructors:
+                ts.append("    if (!nativeThis)")
+                ts.append("        return {};" if has_result else "        return;")
+        for parameter in parameters:
+            if not parameter.is_critical:
+                ts.append("    auto %s = %s;" % (nativeArgument(parameter), self.buildJNIArgument(parameter)))
+        ts.append("    auto result = [&] {" if has_result else "    {")
+        for parameter in parameters:
+            if parameter.is_critical:
+                ts.append("        JNI::CriticalArrayView<%s> %s(%s, env);" % (self.resolveInternalType(parameter.base_type, parameter.dimensions), nativeArgument(parameter), parameter.name))
+        ts.append("        %s%s%s(%s);" % ('return ' if has_result else '', '$CLASS_PATH::' if is_static else 'nativeThis->', name, ', '.join([nativeArgument(parameter) for parameter in parameters])))
+        if has_result:
+            ts.append("    }();")
+            if isStringType(getTypeName(return_type)):
+                ts.append("    return JNI::toManaged(env, result);")
+            else:
+                ts.append("    return %s;" % self.surroundWithCast(getTypeName(return_type), getTypeDimensions(return_type), 'result', True))
+        else:
+            ts.append("    }")
+        ts.append('}')
+        self.puts('\n'.join(ts))
+        self.EOL()
+
     def implementConstruction(self, called_by_native, parameters):
         ts = (
         "static jmethodID mid = $JNIENV->GetMethodID($CLASS_ID",
@@ -1955,8 +2092,8 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
         name_parts = string.split(name, '.')
         jni_signature_map.mapType(name_parts[-1], [''.join(['L', '/'.join(name_parts), ';'])])
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
-        StubGeneratorBackend.processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+        StubGeneratorBackend.processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
 
         ts = (
         "$LOCAL_REF<$CLASS_PATH> $CLASS_PATH::fromRef(JNI::ref_t ref)",
@@ -1964,7 +2101,7 @@ class NativesJNIStubGeneratorBackend(StubGeneratorBackend):
         "    return nativeObject(ref);",
         "}",
         "",
-        "$LOCAL_REF<$CLASS_PATH> $CLASS_PATH::fromPtr(std::shared_ptr<$EXTERNAL_NAMESPACE::$CLASS_PATH>&)",
+        "$LOCAL_REF<$CLASS_PATH> $CLASS_PATH::fromPtr(std::shared_ptr<$EXTERNAL_NAMESPACE::$CLASS_PATH>)",
         "{",
         "    return $LOCAL_REF<$CLASS_PATH>(); // FIXME: Error if fromPtr() is used. This method should be removed.",
         "}",
@@ -2087,7 +2224,7 @@ class ManagedCPPStubGeneratorBackend(StubGeneratorBackend):
         "void $CLASS_PATH::$CONSTRUCTOR_NAME($CONSTRUCTOR_PARAMETERS)",
         "{",
         "    auto* nativePtr = Natives::$CLASS_PATH::$CONSTRUCTOR_NAME($CONSTRUCTOR_ARGUMENTS);",
-        "    $NATIVE_OBJECT_FIELD = reinterpret_cast<int32_t>(nativePtr); // Reference adopted",
+        "    $NATIVE_OBJECT_FIELD = JNI::adoptNativeObjectField<decltype($NATIVE_OBJECT_FIELD)>(nativePtr); // Reference adopted",
         "}",
         "")
         ts = string.Template('\n'.join(ts)).safe_substitute({
@@ -2102,7 +2239,9 @@ class ManagedCPPStubGeneratorBackend(StubGeneratorBackend):
         ts = (
         "void $CLASS_PATH::%1()",
         "{",
-        "    reinterpret_cast<Natives::$CLASS_PATH*>($NATIVE_OBJECT_FIELD)->deref();",
+        "    JNI::NativeObject* nativeObject = JNI::releaseNativeObjectField($NATIVE_OBJECT_FIELD);",
+        "    if (nativeObject)",
+        "        nativeObject->deref();",
         "}",
         "")
         self.puts('\n'.join(ts),  name)
@@ -2114,8 +2253,8 @@ class ManagedCPPStubGeneratorBackend(StubGeneratorBackend):
         self.EOL()
         self.EOL()
 
-    def processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
-        StubGeneratorBackend.processClassBegin(self, name, native_export_macro, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
+    def processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors):
+        StubGeneratorBackend.processClassBegin(self, name, native_export_macro, native_ref_count, extends, class_type_parameters, has_trivial_constructor, has_native_constructors)
 
         ts = (
         "static std::function<$CLASS_PATH* ()> s_factory;",
@@ -2150,7 +2289,7 @@ class ManagedCPPStubGeneratorBackend(StubGeneratorBackend):
             ts = (
             "static JNI::ref_t refLocal($CLASS_PATH* thisObject)",
             "{",
-            "    return reinterpret_cast<$EXTERNAL_NAMESPACE::$CLASS_PATH*>(thisObject->$NATIVE_OBJECT_FIELD)->refLocal();",
+            "    return JNI::nativeObjectFromField(thisObject->$NATIVE_OBJECT_FIELD)->refLocal();",
             "}",
             "")
             self.puts('\n'.join(ts))
@@ -2259,8 +2398,12 @@ def generateBindings(frontend, backend, source_file, target_file):
 
 def generatedHeaderLocation(target_path, source_file, is_managed):
     target_header_path = ''.join([target_path, source_file.package, '/', managed_files_suffix if is_managed else natives_files_suffix])
-    if not os.path.exists(target_header_path):
+    try:
         os.makedirs(target_header_path)
+    except OSError as exception:
+        # Stubs of the same package may be generated in parallel.
+        if exception.errno != errno.EEXIST:
+            raise
     return ''.join([target_header_path, '/', source_file.filename_only, ".h"])
 
 def generateBindingsHeader(source_file, output_path):
@@ -2292,11 +2435,14 @@ if __name__ == '__main__':
     argparser.add_argument('--android', type=str, help='Path to put generated Android C++ bindings')
     argparser.add_argument('--generic', type=str, help='Path to put generated generic C++ bindings')
     argparser.add_argument('--force', action='store_true', help='Forces interface generation')
+    argparser.add_argument('--string-views', type=str, choices=sorted(string_view_types.keys()), help='Passes String parameters of native methods as JNI::Utf8View or JNI::Utf16View instead of std::string')
     if len(sys.argv) <= 1:
         argparser.print_usage()
         sys.exit(1)
     else:
         args = argparser.parse_args()
+        if args.string_views is not None:
+            string_view_type = string_view_types[args.string_views]
 
     def normalizedFilePath(filepath):
         if sys.platform == 'cygwin':
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Per-call cost of getting the current thread's JNIEnv. The "uncached" row
+// redoes what getEnv() used to do on every call; the JNI::getEnv() rows are the
+// thread-local cache that replaced it, and the GetEnv fallback used for threads
+// attached by someone else.
+
+#include "Benchmark.h"
+
+#include <mutex>
+#include <pthread.h>
+#include <thread>
+
+static const int iterations = 10000000;
+
+template<typename Body> static void report(const char* name, Body body)
+{
+    double seconds = Benchmark::bestSeconds(3, [&] {
+        for (int i = 0; i < iterations; ++i) {
+            JNIEnv* volatile env = body();
+            (void)env;
+        }
+    });
+    printf("%-36s %8.2f ns/call\n", name, seconds * 1e9 / iterations);
+}
+
+// The old getEnv(): AttachCurrentThread, then ThreadDestructor::get(), which
+// ran std::call_once and pthread_getspecific to mark the thread for detaching.
+static JNIEnv* uncachedGetEnv(JavaVM* vm)
+{
+    static std::once_flag onceFlag;
+    static pthread_key_t threadDestructorKey;
+    std::call_once(onceFlag, [] {
+        pthread_key_create(&threadDestructorKey, nullptr);
+    });
+
+    JNIEnv* env = nullptr;
+    if (vm->AttachCurrentThread(reinterpret_cast<void**>(&env), nullptr) != JNI_OK)
+        return nullptr;
+    if (!pthread_getspecific(threadDestructorKey))
+        pthread_setspecific(threadDestructorKey, &threadDestructorKey);
+    return env;
+}
+
+int main(int, char**)
+{
+    if (!Benchmark::startVM())
+        return 1;
+
+    std::thread([] {
+        JavaVM* vm = JNI::getVM();
+        JNIEnv* attachedEnv = JNI::getEnv(); // Attaches and caches the env.
+
+        report("uncached getEnv (before)", [vm] { return uncachedGetEnv(vm); });
+        report("GetEnv", [vm] {
+            JNIEnv* env = nullptr;
+            vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+            return env;
+        });
+        report("JNI::getEnv (cached)", [] { return JNI::getEnv(); });
+        {
+            JNI::ScopedEnv scopedEnv(attachedEnv);
+            report("JNI::getEnv (inside ScopedEnv)", [] { return JNI::getEnv(); });
+        }
+    }).join();
+
+    // Attached behind the library's back, so getEnv() cannot cache the env and asks GetEnv every time.
+    std::thread([] {
+        JavaVM* vm = JNI::getVM();
+        JNIEnv* env = nullptr;
+        vm->AttachCurrentThread(reinterpret_cast<void**>(&env), nullptr);
+        report("JNI::getEnv (attached elsewhere)", [] { return JNI::getEnv(); });
+        vm->DetachCurrentThread();
+    }).join();
+    return 0;
+}
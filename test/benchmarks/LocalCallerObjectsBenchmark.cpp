@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Cost of a push/pop pair on the local caller object stack at a given nesting
+// depth, next to the linked list it replaced, which allocated a node for every
+// push while another was pending. Depths up to 16 stay inline; deeper ones use
+// the spill buffer. The last column builds that many NativeObjects nested the
+// way generated constructors nest: every caller object is pushed before the
+// innermost constructor pops its own. The caller objects are null, so binding
+// makes no JNI call and the column shows what the stack adds to a construction.
+
+#include <androidjni/JNIExportMacros.h>
+#include <androidjni/NativeObject.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+static const int iterations = 1000000;
+
+namespace ListStack {
+
+// pushLocalCallerObjectRef() and popLocalCallerObjectRef() before the inline stack.
+struct LocalCallerObject {
+    JNI::ref_t oref;
+    LocalCallerObject* next;
+};
+
+static thread_local LocalCallerObject localCallerObjects;
+
+static JNI::ref_t pop()
+{
+    JNI::ref_t ref = 0;
+    std::swap(ref, localCallerObjects.oref);
+
+    if (!localCallerObjects.next)
+        return ref;
+
+    std::unique_ptr<LocalCallerObject> next(localCallerObjects.next);
+    localCallerObjects.oref = next->oref;
+    localCallerObjects.next = next->next;
+    return ref;
+}
+
+static void push(JNI::ref_t ref)
+{
+    if (!localCallerObjects.oref) {
+        localCallerObjects.oref = ref;
+        return;
+    }
+
+    LocalCallerObject* next = new LocalCallerObject;
+    next->oref = localCallerObjects.oref;
+    next->next = localCallerObjects.next;
+    localCallerObjects.oref = ref;
+    localCallerObjects.next = next;
+}
+
+// Called through these so that, like the library functions, they are not inlined.
+static JNI::ref_t (*volatile popList)() = pop;
+static void (*volatile pushList)(JNI::ref_t) = push;
+
+} // namespace ListStack
+
+class Wrapper : public JNI::RefCountedNativeObject<> {
+};
+
+static void constructNested(size_t depth)
+{
+    JNI::pushLocalCallerObjectRef(nullptr);
+    if (depth > 1)
+        constructNested(depth - 1);
+    (new Wrapper)->deref();
+}
+
+template<typename Body> static double nanosecondsPer(size_t depth, Body body)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        body();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(iterations) * depth);
+}
+
+int main(int, char**)
+{
+    printf("%6s %20s %20s %20s\n", "depth", "inline ns/push+pop", "list ns/push+pop", "ns/nested object");
+    for (size_t depth : { 1, 2, 4, 8, 12, 15, 16, 17, 24, 32 }) {
+        JNI::ref_t sink = nullptr;
+        double inlineStack = nanosecondsPer(depth, [&] {
+            for (size_t level = 0; level < depth; ++level)
+                JNI::pushLocalCallerObjectRef(reinterpret_cast<JNI::ref_t>(level + 1));
+            for (size_t level = 0; level < depth; ++level)
+                sink = JNI::popLocalCallerObjectRef();
+        });
+        double listStack = nanosecondsPer(depth, [&] {
+            for (size_t level = 0; level < depth; ++level)
+                ListStack::pushList(reinterpret_cast<JNI::ref_t>(level + 1));
+            for (size_t level = 0; level < depth; ++level)
+                sink = ListStack::popList();
+        });
+        double construction = nanosecondsPer(depth, [depth] { constructNested(depth); });
+        printf("%6zu %20.2f %20.2f %20.2f%s\n", depth, inlineStack, listStack, construction, sink ? "" : " (empty)");
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Throughput of converting std::string arrays to and from String[].
+
+#include "Benchmark.h"
+
+#include <androidjni/PassArray.h>
+
+#include <string>
+#include <vector>
+
+int main(int, char**)
+{
+    if (!Benchmark::startVM())
+        return 1;
+
+    printf("%10s %16s %16s\n", "strings", "to String[]/s", "from String[]/s");
+    for (size_t count : { 10000, 25000, 50000, 100000 }) {
+        std::vector<std::string> strings(count);
+        for (size_t i = 0; i < count; ++i)
+            strings[i] = "element " + std::to_string(i) + " \xea\xb0\x80\xeb\x82\x98\xeb\x8b\xa4";
+
+        double toManaged = Benchmark::bestSeconds(5, [&] {
+            JNI::PassArray<std::string> array(strings);
+        });
+
+        JNI::PassArray<std::string> source(strings);
+        double toNative = Benchmark::bestSeconds(5, [&] {
+            JNI::PassArray<std::string> array(source.get());
+            array.data();
+        });
+
+        printf("%10zu %16.0f %16.0f\n", count, count / toManaged, count / toNative);
+    }
+    return 0;
+}
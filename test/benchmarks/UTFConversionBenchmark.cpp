@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Per-call cost of converting strings to and from java.lang.String, with the
+// JVM's modified UTF-8 functions next to the transcoder in UTFConversion.cpp
+// that toManaged() and toNative() use.
+
+#include "Benchmark.h"
+
+#include <androidjni/MarshalingHelpers.h>
+
+#include <string>
+
+// Roughly this many bytes are converted per timed run, whatever the string length.
+static const size_t bytesPerRun = 64 << 20;
+
+template<typename Body> static double nanosecondsPerCall(size_t calls, Body body)
+{
+    double seconds = Benchmark::bestSeconds(3, [&] {
+        for (size_t i = 0; i < calls; ++i)
+            body();
+    });
+    return seconds * 1e9 / calls;
+}
+
+static std::string makeText(size_t length, const char* unit)
+{
+    std::string text;
+    while (text.size() < length)
+        text += unit;
+    return text;
+}
+
+int main(int, char**)
+{
+    if (!Benchmark::startVM())
+        return 1;
+
+    JNIEnv* env = JNI::getEnv();
+
+    struct Sample {
+        const char* name;
+        const char* unit;
+    };
+    // The Hangul syllables are 3 bytes each; neither text has U+0000 or
+    // supplementary characters, so standard and modified UTF-8 agree.
+    const Sample samples[] = {
+        { "ascii", "The quick brown fox jumps over the lazy dog. " },
+        { "mixed", "element \xea\xb0\x80\xeb\x82\x98\xeb\x8b\xa4 " },
+    };
+
+    printf("%-6s %9s %14s %14s %18s %14s\n", "text", "bytes", "NewStringUTF", "toManaged", "GetStringUTFChars", "toNative");
+    for (const Sample& sample : samples) {
+        for (size_t length : { 16, 1024, 1 << 20 }) {
+            std::string text = makeText(length, sample.unit);
+            size_t calls = std::max<size_t>(bytesPerRun / text.size(), 16);
+
+            double newStringUTF = nanosecondsPerCall(calls, [&] {
+                env->DeleteLocalRef(env->NewStringUTF(text.c_str()));
+            });
+            double toManaged = nanosecondsPerCall(calls, [&] {
+                env->DeleteLocalRef(JNI::toManaged(env, text));
+            });
+
+            jstring string = JNI::toManaged(env, text);
+            double getStringUTFChars = nanosecondsPerCall(calls, [&] {
+                const char* chars = env->GetStringUTFChars(string, nullptr);
+                std::string copy(chars, env->GetStringUTFLength(string));
+                env->ReleaseStringUTFChars(string, chars);
+            });
+            double toNative = nanosecondsPerCall(calls, [&] {
+                std::string copy = JNI::toNative(env, string);
+            });
+            env->DeleteLocalRef(string);
+
+            printf("%-6s %9zu %11.0f ns %11.0f ns %15.0f ns %11.0f ns\n",
+                sample.name, text.size(), newStringUTF, toManaged, getStringUTFChars, toNative);
+        }
+    }
+    return 0;
+}
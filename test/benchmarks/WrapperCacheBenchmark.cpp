@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Cost of converting the same Java object to a native wrapper again. Without a
+// @NativeConstructor, fromRef() builds a new wrapper and weak global reference
+// each time. A cache in front of it would still pay, on every hit, for a
+// System.identityHashCode() upcall and an IsSameObject() check under its lock;
+// the second row times exactly that.
+
+#include "Benchmark.h"
+
+#include <androidjni/NativeObject.h>
+
+#include <mutex>
+
+static const int iterations = 1000000;
+
+class Wrapper : public JNI::RefCountedNativeObject<> {
+};
+
+template<typename Body> static void report(const char* name, Body body)
+{
+    double seconds = Benchmark::bestSeconds(3, [&] {
+        for (int i = 0; i < iterations; ++i)
+            body();
+    });
+    printf("%-44s %8.2f ns/call\n", name, seconds * 1e9 / iterations);
+}
+
+int main(int, char**)
+{
+    if (!Benchmark::startVM())
+        return 1;
+
+    JNIEnv* env = JNI::getEnv();
+    jobject object = env->AllocObject(env->FindClass("java/lang/Object"));
+    jclass systemClass = env->FindClass("java/lang/System");
+    jmethodID identityHashCode = env->GetStaticMethodID(systemClass, "identityHashCode", "(Ljava/lang/Object;)I");
+
+    report("new wrapper (uncached fromRef)", [object] {
+        JNI::pushLocalCallerObjectRef(object);
+        (new Wrapper)->deref();
+    });
+
+    JNI::pushLocalCallerObjectRef(object);
+    Wrapper* cached = new Wrapper;
+    jweak cachedBind = env->NewWeakGlobalRef(object);
+    std::mutex mutex;
+    report("cache hit (identityHashCode + IsSameObject)", [&] {
+        volatile jint hash = env->CallStaticIntMethod(systemClass, identityHashCode, object);
+        (void)hash;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (env->IsSameObject(object, cachedBind)) {
+            cached->ref();
+            cached->deref();
+        }
+    });
+    env->DeleteWeakGlobalRef(cachedBind);
+    cached->deref();
+    return 0;
+}
@@ -70,7 +70,7 @@ public class StringGenerator {
     }
 
     @NativeObjectField
-    private int mNativePtr;
+    private long mNativePtr;
 
     protected void finalize() {
         Log.d("NativeObject", "Called finalize()");
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <androidjni/JNIExportMacros.h>
+#include <androidjni/JavaVM.h>
+
+// Runs the test classes on a desktop JVM. StringGenerator loads libtestlib
+// from java.library.path, whose JNI_OnLoad registers the natives as on Android.
+int main(int, char**)
+{
+    JavaVM* vm = JNI::loadVM(nullptr, {
+        "-Djava.class.path=" TESTAPP_CLASS_PATH,
+        "-Djava.library.path=" TESTAPP_LIBRARY_PATH,
+    });
+    if (!vm)
+        return 1;
+
+    JNIEnv* env = JNI::getEnv();
+    jclass testClass = env->FindClass("com/example/test/HostTest");
+    jmethodID run = testClass ? env->GetStaticMethodID(testClass, "run", "()V") : 0;
+    if (run)
+        env->CallStaticVoidMethod(testClass, run);
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        return 1;
+    }
+
+    vm->DestroyJavaVM();
+    return 0;
+}
@@ -24,8 +24,9 @@
  */
 
 #include <androidjni/JavaVM.h>
+#include <androidjni/ReferenceCensus.h>
 
-#include <com/example/test/StringGeneratorNativesBase.h> // for registerClass()
+#include <com/example/test/Natives/StringGenerator.h> // for registerClass()
 
 /* This is a trivial JNI example where we use a native method
  * to return a new VM String. See the corresponding Java source
@@ -48,3 +49,9 @@ JNI_EXPORT jint JNI_OnLoad(JavaVM* vm, void* /*reserved*/)
     com::example::test::Natives::StringGenerator::registerClass();
     return JNI_VERSION_1_4;
 }
+
+JNI_EXPORT void JNI_OnUnload(JavaVM* /*vm*/, void* /*reserved*/)
+{
+    if (JNI::isReferenceCensusEnabled())
+        ALOGD("%s", JNI::referenceCensusReport().c_str());
+}
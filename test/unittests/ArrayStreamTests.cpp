@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Windowing, slicing and flushing of the generic platform's array streams,
+// which share their constructors with the JNI platform. Needs no JVM.
+
+#include <androidjni/ArrayStream.h>
+
+#include <cstdio>
+#include <vector>
+
+static int failures = 0;
+
+#define EXPECT(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while (0)
+
+static std::vector<int32_t> sequence(size_t count)
+{
+    std::vector<int32_t> values(count);
+    for (size_t i = 0; i < count; ++i)
+        values[i] = static_cast<int32_t>(i);
+    return values;
+}
+
+static std::vector<int32_t> contents(const JNI::PassArray<int32_t>& array)
+{
+    return std::vector<int32_t>(array.data(), array.data() + array.count());
+}
+
+static void testReaderWindows()
+{
+    const JNI::PassArray<int32_t> array(sequence(10));
+    JNI::ArrayStreamReader<int32_t> reader(array, 0, SIZE_MAX, 4);
+    EXPECT(reader.length() == 10);
+
+    std::vector<size_t> counts;
+    std::vector<int32_t> read;
+    for (auto& window : reader) {
+        EXPECT(window.offset() == read.size());
+        counts.push_back(window.count());
+        read.insert(read.end(), window.begin(), window.end());
+    }
+    EXPECT(counts == std::vector<size_t>({ 4, 4, 2 }));
+    EXPECT(read == sequence(10));
+    EXPECT(reader.position() == 10);
+
+    // Iterating again starts over.
+    size_t total = 0;
+    for (auto& window : reader)
+        total += window.count();
+    EXPECT(total == 10);
+}
+
+static void testReaderSlices()
+{
+    const JNI::PassArray<int32_t> array(sequence(10));
+
+    JNI::ArrayStreamReader<int32_t> slice(array, 3, 5, 2);
+    std::vector<int32_t> read;
+    for (auto& window : slice)
+        read.insert(read.end(), window.begin(), window.end());
+    EXPECT(read == std::vector<int32_t>({ 3, 4, 5, 6, 7 }));
+
+    JNI::ArrayStreamReader<int32_t> tail(array, 8);
+    EXPECT(tail.length() == 2);
+
+    JNI::ArrayStreamReader<int32_t> past(array, 12);
+    EXPECT(past.length() == 0);
+    EXPECT(past.begin() == past.end());
+
+    // A window size of zero still makes progress, one element at a time.
+    JNI::ArrayStreamReader<int32_t> single(array, 0, 3, 0);
+    size_t windows = 0;
+    for (auto& window : single) {
+        EXPECT(window.count() == 1);
+        ++windows;
+    }
+    EXPECT(windows == 3);
+}
+
+static void testWriterFlushes()
+{
+    JNI::PassArray<int32_t> array(std::vector<int32_t>(8, -1));
+    {
+        JNI::ArrayStreamWriter<int32_t> writer(array, 0, SIZE_MAX, 4);
+        EXPECT(writer.put(0));
+        EXPECT(writer.put(1));
+        EXPECT(writer.position() == 2);
+        // Still buffered below the window size.
+        EXPECT(contents(array) == std::vector<int32_t>({ -1, -1, -1, -1, -1, -1, -1, -1 }));
+
+        EXPECT(writer.put(2));
+        EXPECT(writer.put(3));
+        EXPECT(contents(array) == std::vector<int32_t>({ 0, 1, 2, 3, -1, -1, -1, -1 }));
+
+        EXPECT(writer.put(4));
+        writer.flush();
+        EXPECT(contents(array) == std::vector<int32_t>({ 0, 1, 2, 3, 4, -1, -1, -1 }));
+
+        EXPECT(writer.put(5));
+    }
+    // The destructor flushes what is left.
+    EXPECT(contents(array) == std::vector<int32_t>({ 0, 1, 2, 3, 4, 5, -1, -1 }));
+}
+
+static void testWriterSlices()
+{
+    JNI::PassArray<int32_t> array(std::vector<int32_t>(8, -1));
+    {
+        JNI::ArrayStreamWriter<int32_t> writer(array, 2, 4, 2);
+        EXPECT(writer.length() == 4);
+
+        // Larger than the window, so it bypasses the buffer.
+        std::vector<int32_t> values = { 10, 11, 12 };
+        EXPECT(writer.write(values.data(), values.size()) == 3);
+
+        // Only one element is left in the slice.
+        EXPECT(writer.write(values.data(), values.size()) == 1);
+        EXPECT(!writer.put(99));
+        EXPECT(writer.position() == 4);
+    }
+    EXPECT(contents(array) == std::vector<int32_t>({ -1, -1, 10, 11, 12, 10, -1, -1 }));
+
+    JNI::ArrayStreamWriter<int32_t> past(array, 9);
+    EXPECT(past.length() == 0);
+    EXPECT(!past.put(1));
+}
+
+static void testWriterThenReader()
+{
+    JNI::PassArray<bool> array(std::vector<bool>(5, false));
+    {
+        JNI::ArrayStreamWriter<bool> writer(array, 1, 3);
+        for (int i = 0; i < 3; ++i)
+            writer.put(true);
+    }
+
+    std::vector<bool> read;
+    JNI::ArrayStreamReader<bool> reader(array);
+    for (auto& window : reader)
+        read.insert(read.end(), window.begin(), window.end());
+    EXPECT(read == std::vector<bool>({ false, true, true, true, false }));
+}
+
+int main(int, char**)
+{
+    testReaderWindows();
+    testReaderSlices();
+    testWriterFlushes();
+    testWriterSlices();
+    testWriterThenReader();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Moving a reference wrapper must hand over the reference it holds without
+// creating or deleting any, and copying a SharedGlobalRef must only share it.
+// ReferenceFunctions is replaced here by stubs that count their calls, so the
+// test needs no JVM and fails on any call made while moving or copying.
+
+#include <androidjni/GlobalRef.h>
+#include <androidjni/LocalRef.h>
+#include <androidjni/NativeObject.h>
+#include <androidjni/PassLocalRef.h>
+#include <androidjni/SharedGlobalRef.h>
+#include <androidjni/WeakGlobalRef.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+static int referenceCalls = 0;
+static uintptr_t nextReference = 0x1000;
+
+static JNI::ref_t newReference(const void* ref)
+{
+    if (!ref)
+        return nullptr;
+    ++referenceCalls;
+    return reinterpret_cast<JNI::ref_t>(nextReference += 8);
+}
+
+static void deleteReference(const void* ref)
+{
+    if (ref)
+        ++referenceCalls;
+}
+
+static std::vector<JNI::ref_t> derefedGlobals;
+
+namespace JNI {
+
+ref_t refLocal(ref_t ref) { return newReference(ref); }
+void derefLocal(ref_t ref) { deleteReference(ref); }
+ref_t refGlobal(ref_t ref) { return newReference(ref); }
+void derefGlobal(ref_t ref) { deleteReference(ref); derefedGlobals.push_back(ref); }
+bool isExpiredWeakGlobal(weak_t) { ++referenceCalls; return false; }
+weak_t refWeakGlobal(ref_t ref) { return reinterpret_cast<weak_t>(newReference(ref)); }
+void derefWeakGlobal(weak_t ref) { deleteReference(ref); }
+ref_t promoteWeakGlobal(weak_t ref) { ++referenceCalls; return newReference(ref); }
+ref_t popLocalCallerObjectRef() { ++referenceCalls; return nullptr; }
+void pushLocalCallerObjectRef(ref_t) { ++referenceCalls; }
+
+} // namespace JNI
+
+class Object : public JNI::RefCountedNativeObject<> {
+public:
+    static JNI::PassLocalRef<Object> fromRef(JNI::ref_t ref) { return JNI::adoptRef(ref, static_cast<Object*>(nullptr)); }
+};
+
+static int failures = 0;
+
+#define EXPECT_NO_REFERENCE_CALLS(statement) \
+    do { \
+        int callsBefore = referenceCalls; \
+        statement; \
+        if (referenceCalls != callsBefore) { \
+            fprintf(stderr, "%s:%d: %s made %d reference calls\n", __FILE__, __LINE__, #statement, referenceCalls - callsBefore); \
+            ++failures; \
+        } \
+    } while (0)
+
+#define EXPECT_GLOBAL_DEREFS(ref, expected) \
+    do { \
+        long derefs = std::count(derefedGlobals.begin(), derefedGlobals.end(), ref); \
+        if (derefs != (expected)) { \
+            fprintf(stderr, "%s:%d: global reference deleted %ld times, expected %d\n", __FILE__, __LINE__, derefs, expected); \
+            ++failures; \
+        } \
+    } while (0)
+
+static JNI::ref_t object()
+{
+    static int managedObject;
+    return &managedObject;
+}
+
+static void testLocalRef()
+{
+    JNI::LocalRef<Object> a(JNI::refLocal(object()), static_cast<Object*>(nullptr));
+    JNI::LocalRef<Object> b;
+    EXPECT_NO_REFERENCE_CALLS(JNI::LocalRef<Object> moved(std::move(a)); b = std::move(moved));
+    EXPECT_NO_REFERENCE_CALLS(JNI::LocalRef<JNI::AnyObject> converted(std::move(b)));
+}
+
+static void testPassLocalRef()
+{
+    JNI::PassLocalRef<Object> a = Object::fromRef(JNI::refLocal(object()));
+    JNI::PassLocalRef<Object> b;
+    EXPECT_NO_REFERENCE_CALLS(JNI::PassLocalRef<Object> moved(std::move(a)); b = std::move(moved));
+}
+
+static void testGlobalRef()
+{
+    JNI::GlobalRef<Object> a(JNI::refGlobal(object()), static_cast<Object*>(nullptr));
+    JNI::GlobalRef<Object> b;
+    EXPECT_NO_REFERENCE_CALLS(JNI::GlobalRef<Object> moved(std::move(a)); b = std::move(moved));
+    EXPECT_NO_REFERENCE_CALLS(JNI::GlobalRef<JNI::AnyObject> converted(std::move(b)));
+}
+
+static void testWeakGlobalRef()
+{
+    JNI::WeakGlobalRef<Object> a(object());
+    JNI::WeakGlobalRef<Object> b;
+    EXPECT_NO_REFERENCE_CALLS(JNI::WeakGlobalRef<Object> moved(std::move(a)); b = std::move(moved));
+}
+
+static void testSharedGlobalRef()
+{
+    JNI::SharedGlobalRef<Object> a(JNI::refGlobal(object()), static_cast<Object*>(nullptr));
+    JNI::SharedGlobalRef<Object> b;
+    EXPECT_NO_REFERENCE_CALLS(JNI::SharedGlobalRef<Object> moved(std::move(a)); b = std::move(moved));
+}
+
+static void testSharedGlobalRefCopies()
+{
+    JNI::ref_t ref;
+    {
+        JNI::SharedGlobalRef<Object> a(object(), static_cast<Object*>(nullptr));
+        ref = a.get();
+        JNI::SharedGlobalRef<Object> b;
+        EXPECT_NO_REFERENCE_CALLS(b = a);
+        EXPECT_NO_REFERENCE_CALLS(JNI::SharedGlobalRef<Object> copy(b); JNI::SharedGlobalRef<Object> assigned; assigned = copy);
+        EXPECT_NO_REFERENCE_CALLS(std::vector<JNI::SharedGlobalRef<Object>> copies(8, a));
+        EXPECT_NO_REFERENCE_CALLS(a = b);
+        EXPECT_NO_REFERENCE_CALLS(a.reset());
+        if (b.useCount() != 1) {
+            fprintf(stderr, "%s:%d: %d owners left, expected 1\n", __FILE__, __LINE__, b.useCount());
+            ++failures;
+        }
+        EXPECT_GLOBAL_DEREFS(ref, 0);
+    }
+    EXPECT_GLOBAL_DEREFS(ref, 1);
+}
+
+// Converting from or to another wrapper creates a reference of its own; the
+// shared one is still deleted exactly once, with its last owner.
+static void testSharedGlobalRefConversions()
+{
+    JNI::ref_t globalRef, sharedFromGlobal;
+    {
+        JNI::GlobalRef<Object> global(JNI::refGlobal(object()), static_cast<Object*>(nullptr));
+        globalRef = global.get();
+        {
+            JNI::SharedGlobalRef<Object> shared(global);
+            sharedFromGlobal = shared.get();
+            JNI::SharedGlobalRef<Object> copy = shared;
+        }
+        EXPECT_GLOBAL_DEREFS(sharedFromGlobal, 1);
+        EXPECT_GLOBAL_DEREFS(globalRef, 0);
+    }
+    EXPECT_GLOBAL_DEREFS(globalRef, 1);
+
+    JNI::ref_t sharedFromLocal;
+    {
+        JNI::LocalRef<Object> local(JNI::refLocal(object()), static_cast<Object*>(nullptr));
+        JNI::SharedGlobalRef<Object> shared(local);
+        sharedFromLocal = shared.get();
+        JNI::SharedGlobalRef<Object> copy = shared;
+        shared.reset();
+        EXPECT_GLOBAL_DEREFS(sharedFromLocal, 0);
+    }
+    EXPECT_GLOBAL_DEREFS(sharedFromLocal, 1);
+
+    JNI::ref_t sharedFromPass;
+    {
+        JNI::SharedGlobalRef<Object> shared(Object::fromRef(JNI::refLocal(object())));
+        sharedFromPass = shared.get();
+        JNI::SharedGlobalRef<Object> copy = shared;
+        EXPECT_GLOBAL_DEREFS(sharedFromPass, 0);
+    }
+    EXPECT_GLOBAL_DEREFS(sharedFromPass, 1);
+
+    JNI::ref_t shared, derivedGlobal;
+    {
+        JNI::SharedGlobalRef<Object> a(object(), static_cast<Object*>(nullptr));
+        shared = a.get();
+        JNI::GlobalRef<Object> global(a);
+        derivedGlobal = global.get();
+        JNI::LocalRef<Object> local(a);
+        JNI::PassLocalRef<Object> passed(a);
+        {
+            JNI::SharedGlobalRef<Object> b = a;
+            a.reset();
+        }
+        // The wrappers made from it hold their own references.
+        EXPECT_GLOBAL_DEREFS(shared, 1);
+        EXPECT_GLOBAL_DEREFS(derivedGlobal, 0);
+    }
+    EXPECT_GLOBAL_DEREFS(shared, 1);
+    EXPECT_GLOBAL_DEREFS(derivedGlobal, 1);
+}
+
+// Reallocation moves the elements, since the wrappers' move constructors are noexcept.
+static void testVectorGrowth()
+{
+    std::vector<JNI::LocalRef<Object>> locals;
+    std::vector<JNI::GlobalRef<Object>> globals;
+    for (int i = 0; i < 4; ++i) {
+        locals.emplace_back(JNI::refLocal(object()), static_cast<Object*>(nullptr));
+        globals.emplace_back(JNI::refGlobal(object()), static_cast<Object*>(nullptr));
+    }
+    EXPECT_NO_REFERENCE_CALLS(locals.reserve(locals.capacity() * 4));
+    EXPECT_NO_REFERENCE_CALLS(globals.reserve(globals.capacity() * 4));
+
+    std::vector<JNI::PassLocalRef<Object>> passed;
+    passed.push_back(Object::fromRef(JNI::refLocal(object())));
+    EXPECT_NO_REFERENCE_CALLS(passed.reserve(passed.capacity() * 4));
+}
+
+int main(int, char**)
+{
+    testLocalRef();
+    testPassLocalRef();
+    testGlobalRef();
+    testWeakGlobalRef();
+    testSharedGlobalRef();
+    testSharedGlobalRefCopies();
+    testSharedGlobalRefConversions();
+    testVectorGrowth();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Repeated InternedString constants must cross without allocating, and the
+// cache must keep finding entries after evictions recycle their slots.
+// ReferenceFunctions is replaced by stubs, so the test needs no JVM.
+
+#include <androidjni/InternedString.h>
+#include <androidjni/StringInternCache.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+static int allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+static uintptr_t nextReference = 0x1000;
+
+namespace JNI {
+
+ref_t refLocal(ref_t ref) { return ref ? reinterpret_cast<ref_t>(nextReference += 8) : nullptr; }
+void derefLocal(ref_t) { }
+ref_t refGlobal(ref_t ref) { return ref ? reinterpret_cast<ref_t>(nextReference += 8) : nullptr; }
+void derefGlobal(ref_t) { }
+
+} // namespace JNI
+
+static int failures = 0;
+
+#define EXPECT(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while (0)
+
+static int creates = 0;
+
+static JNI::ref_t intern(JNI::StringInternCache& cache, const JNI::InternedString& value)
+{
+    return cache.refLocal(value.data(), value.size(), [] {
+        ++creates;
+        return reinterpret_cast<JNI::ref_t>(nextReference += 8);
+    });
+}
+
+static void testConstantsDoNotAllocate()
+{
+    JNI::StringInternCache cache(16);
+    const char* longConstant = "a key that is longer than any small string buffer";
+    intern(cache, "tag");
+    intern(cache, longConstant);
+
+    int allocationsBefore = allocations;
+    int createsBefore = creates;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT(intern(cache, "tag"));
+        EXPECT(intern(cache, longConstant));
+    }
+    EXPECT(allocations == allocationsBefore);
+    EXPECT(creates == createsBefore);
+
+    JNI::StringInternCacheStatistics statistics = cache.statistics();
+    EXPECT(statistics.size == 2);
+    EXPECT(statistics.hits == 200);
+    EXPECT(statistics.misses == 2);
+}
+
+static void testOwnedValues()
+{
+    JNI::StringInternCache cache(16);
+    std::string dynamic = "tag";
+    JNI::InternedString owned(dynamic + "-" + std::to_string(1));
+    EXPECT(owned.string() == "tag-1");
+    EXPECT(owned.size() == 5);
+
+    intern(cache, owned);
+    int createsBefore = creates;
+    intern(cache, "tag-1");
+    EXPECT(creates == createsBefore);
+
+    // Contents with an embedded NUL are told apart by length.
+    intern(cache, JNI::InternedString(std::string("tag\0-1", 6)));
+    EXPECT(creates == createsBefore + 1);
+}
+
+static void testEviction()
+{
+    JNI::StringInternCache cache(2);
+    intern(cache, "first");
+    intern(cache, "second");
+    intern(cache, "a third value, long enough to need its own buffer");
+    EXPECT(cache.statistics().evictions == 1);
+    EXPECT(cache.statistics().size == 2);
+
+    // The recycled slot must not leave a stale key behind.
+    int createsBefore = creates;
+    intern(cache, "second");
+    intern(cache, "a third value, long enough to need its own buffer");
+    EXPECT(creates == createsBefore);
+    intern(cache, "first");
+    EXPECT(creates == createsBefore + 1);
+
+    cache.clear();
+    EXPECT(cache.statistics().size == 0);
+    intern(cache, "first");
+    EXPECT(creates == createsBefore + 2);
+}
+
+int main(int, char**)
+{
+    testConstantsDoNotAllocate();
+    testOwnedValues();
+    testEviction();
+    return failures ? 1 : 0;
+}
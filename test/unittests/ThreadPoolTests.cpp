@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Runs ThreadPool against a desktop JVM, which its workers attach to.
+
+#include <androidjni/JNIExportMacros.h>
+#include <androidjni/JavaVM.h>
+#include <androidjni/ThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while (0)
+
+static int failures = 0;
+
+// A worker runs the tasks it posts itself newest first.
+static void testOrdering()
+{
+    std::vector<char> order;
+    {
+        JNI::ThreadPool pool(1, "order");
+        pool.post([&] {
+            order.push_back('A');
+            pool.post([&] { order.push_back('B'); });
+            pool.post([&] { order.push_back('C'); });
+            pool.post([&] { order.push_back('D'); });
+        });
+    }
+    CHECK((order == std::vector<char> { 'A', 'D', 'C', 'B' }));
+}
+
+// Tasks queued behind a busy worker are taken by the idle one.
+static void testStealing()
+{
+    static const size_t taskCount = 8;
+    std::mutex mutex;
+    std::vector<std::thread::id> runners;
+    std::thread::id posterThread;
+    std::atomic<size_t> done(0);
+    uint64_t steals = 0;
+    {
+        JNI::ThreadPool pool(2, "steal");
+        pool.post([&] {
+            posterThread = std::this_thread::get_id();
+            for (size_t i = 0; i < taskCount; ++i) {
+                pool.post([&] {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    runners.push_back(std::this_thread::get_id());
+                    ++done;
+                });
+            }
+            // Only a thief can run them while this task holds the worker.
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (done < taskCount && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+            for (auto& statistics : pool.statistics())
+                steals += statistics.stealCount;
+        });
+    }
+
+    CHECK(runners.size() == taskCount);
+    for (auto& runner : runners)
+        CHECK(runner != posterThread);
+    CHECK(steals >= taskCount);
+}
+
+// The destructor runs every queued task, including those posted while draining.
+static void testShutdownDraining()
+{
+    static const int taskCount = 1000;
+    std::atomic<int> executed(0);
+    {
+        JNI::ThreadPool pool(4, "drain");
+        for (int i = 0; i < taskCount; ++i) {
+            pool.post([&] {
+                ++executed;
+                pool.post([&] { ++executed; });
+            });
+        }
+    }
+    CHECK(executed == 2 * taskCount);
+}
+
+int main(int, char**)
+{
+    if (!JNI::loadVM(nullptr, { }))
+        return 77; // No JVM to attach to; reported as skipped.
+
+    testOrdering();
+    testStealing();
+    testShutdownDraining();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2015 Naver Labs. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Conversions between UTF-16 and UTF-8 for what the vectorized ASCII loops
+// hand over to the scalar code: surrogates, malformed input, U+0000 and
+// non-ASCII characters on either side of a vector block. Needs no JVM.
+
+#include <androidjni/UTFConversion.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint16_t> Units;
+
+static int failures = 0;
+
+static std::string hex(const Units& units)
+{
+    std::string result;
+    char digits[8];
+    for (uint16_t unit : units) {
+        snprintf(digits, sizeof(digits), " %04X", unit);
+        result += digits;
+    }
+    return result;
+}
+
+static std::string hex(const std::string& bytes)
+{
+    std::string result;
+    char digits[8];
+    for (char byte : bytes) {
+        snprintf(digits, sizeof(digits), " %02X", static_cast<uint8_t>(byte));
+        result += digits;
+    }
+    return result;
+}
+
+static void expectUTF8(int line, const Units& units, const std::string& expected)
+{
+    std::string result = JNI::utf16ToUTF8(units.data(), units.size());
+    size_t length = JNI::utf8Length(units.data(), units.size());
+    if (result != expected || length != expected.size()) {
+        fprintf(stderr, "%s:%d: utf16ToUTF8(%s) gave%s (utf8Length %zu), expected%s\n",
+            __FILE__, line, hex(units).c_str(), hex(result).c_str(), length, hex(expected).c_str());
+        ++failures;
+    }
+}
+
+static void expectUTF16(int line, const std::string& bytes, const Units& expected)
+{
+    // The buffer has one code unit per byte, which utf8ToUTF16() must never exceed.
+    Units result(bytes.size() + 1, 0xBEEF);
+    size_t length = JNI::utf8ToUTF16(bytes.data(), bytes.size(), result.data());
+    bool overrun = result[bytes.size()] != 0xBEEF;
+    result.resize(length);
+    if (result != expected || overrun) {
+        fprintf(stderr, "%s:%d: utf8ToUTF16(%s) gave%s%s, expected%s\n",
+            __FILE__, line, hex(bytes).c_str(), hex(result).c_str(), overrun ? " past the buffer" : "", hex(expected).c_str());
+        ++failures;
+    }
+}
+
+#define EXPECT_UTF8(units, expected) expectUTF8(__LINE__, units, expected)
+#define EXPECT_UTF16(bytes, expected) expectUTF16(__LINE__, bytes, expected)
+
+static void testSurrogatePairs()
+{
+    EXPECT_UTF8(Units({ 0xD83D, 0xDE00 }), "\xF0\x9F\x98\x80");
+    EXPECT_UTF8(Units({ 0xD800, 0xDC00 }), "\xF0\x90\x80\x80");
+    EXPECT_UTF8(Units({ 0xDBFF, 0xDFFF }), "\xF4\x8F\xBF\xBF");
+    EXPECT_UTF8(Units({ 'a', 0xD83D, 0xDE00, 'b' }), "a\xF0\x9F\x98\x80" "b");
+
+    EXPECT_UTF16("\xF0\x9F\x98\x80", Units({ 0xD83D, 0xDE00 }));
+    EXPECT_UTF16("\xF0\x90\x80\x80", Units({ 0xD800, 0xDC00 }));
+    EXPECT_UTF16("\xF4\x8F\xBF\xBF", Units({ 0xDBFF, 0xDFFF }));
+}
+
+static void testLoneSurrogates()
+{
+    EXPECT_UTF8(Units({ 0xD800 }), "\xEF\xBF\xBD");
+    EXPECT_UTF8(Units({ 0xDC00 }), "\xEF\xBF\xBD");
+    EXPECT_UTF8(Units({ 0xD83D, 'a' }), "\xEF\xBF\xBD" "a");
+    EXPECT_UTF8(Units({ 'a', 0xDE00 }), "a\xEF\xBF\xBD");
+    EXPECT_UTF8(Units({ 0xDE00, 0xD83D }), "\xEF\xBF\xBD\xEF\xBF\xBD");
+    EXPECT_UTF8(Units({ 0xD83D, 0xD83D, 0xDE00 }), "\xEF\xBF\xBD\xF0\x9F\x98\x80");
+}
+
+static void testMalformedUTF8()
+{
+    const uint16_t r = 0xFFFD;
+    EXPECT_UTF16("\x80", Units({ r }));
+    EXPECT_UTF16("a\xBF" "b", Units({ 'a', r, 'b' }));
+    EXPECT_UTF16("\xC0\x80", Units({ r, r })); // Overlong U+0000, i.e. modified UTF-8.
+    EXPECT_UTF16("\xC1\xBF", Units({ r, r }));
+    EXPECT_UTF16("\xE0\x80\xAF", Units({ r, r, r }));
+    EXPECT_UTF16("\xED\xA0\x80", Units({ r, r, r })); // Encoded surrogate.
+    EXPECT_UTF16("\xF4\x90\x80\x80", Units({ r, r, r, r })); // Beyond U+10FFFF.
+    EXPECT_UTF16("\xF5\x80", Units({ r, r }));
+    EXPECT_UTF16("\xFF", Units({ r }));
+    EXPECT_UTF16("\xC3", Units({ r })); // Truncated at the end.
+    EXPECT_UTF16("\xE2\x82", Units({ r, r }));
+    EXPECT_UTF16("\xF0\x9F\x98", Units({ r, r, r }));
+    EXPECT_UTF16("\xE2" "a", Units({ r, 'a' }));
+}
+
+static void testEmbeddedNUL()
+{
+    EXPECT_UTF8(Units({ 0 }), std::string(1, '\0'));
+    EXPECT_UTF8(Units({ 'a', 0, 'b' }), std::string("a\0b", 3));
+    EXPECT_UTF16(std::string("a\0b", 3), Units({ 'a', 0, 'b' }));
+
+    Units units(40, 'x');
+    units[16] = 0;
+    std::string bytes(40, 'x');
+    bytes[16] = '\0';
+    EXPECT_UTF8(units, bytes);
+    EXPECT_UTF16(bytes, units);
+}
+
+// Puts each kind of non-ASCII character at every position of ASCII strings
+// whose lengths straddle one and two 16-unit blocks.
+static void testVectorBoundaries()
+{
+    struct Character {
+        Units units;
+        std::string bytes;
+        Units decoded;
+    };
+    const Character characters[] = {
+        { Units({ 0xE9 }), "\xC3\xA9", Units({ 0xE9 }) },
+        { Units({ 0x4E2D }), "\xE4\xB8\xAD", Units({ 0x4E2D }) },
+        { Units({ 0xD83D, 0xDE00 }), "\xF0\x9F\x98\x80", Units({ 0xD83D, 0xDE00 }) },
+        { Units({ 0xDC00 }), "\xEF\xBF\xBD", Units({ 0xFFFD }) },
+    };
+
+    for (size_t length = 0; length <= 40; ++length) {
+        Units ascii(length);
+        for (size_t i = 0; i < length; ++i)
+            ascii[i] = 'a' + i % 26;
+        std::string asciiBytes(ascii.begin(), ascii.end());
+        EXPECT_UTF8(ascii, asciiBytes);
+        EXPECT_UTF16(asciiBytes, ascii);
+
+        for (size_t position = 0; position < length; ++position) {
+            for (const Character& character : characters) {
+                Units units(ascii.begin(), ascii.begin() + position);
+                units.insert(units.end(), character.units.begin(), character.units.end());
+                units.insert(units.end(), ascii.begin() + position, ascii.end());
+
+                std::string bytes = asciiBytes.substr(0, position) + character.bytes + asciiBytes.substr(position);
+                EXPECT_UTF8(units, bytes);
+
+                Units decoded(ascii.begin(), ascii.begin() + position);
+                decoded.insert(decoded.end(), character.decoded.begin(), character.decoded.end());
+                decoded.insert(decoded.end(), ascii.begin() + position, ascii.end());
+                EXPECT_UTF16(bytes, decoded);
+            }
+        }
+    }
+}
+
+int main(int, char**)
+{
+    testSurrogatePairs();
+    testLoneSurrogates();
+    testMalformedUTF8();
+    testEmbeddedNUL();
+    testVectorBoundaries();
+    return failures ? 1 : 0;
+}